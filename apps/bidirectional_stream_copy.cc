@@ -57,7 +57,7 @@ void bidirectional_stream_copy( Socket& socket, string_view peer_name )
     Direction::Out,
     [&] {
       if ( _outbound.reader().bytes_buffered() ) {
-        _outbound.reader().pop( socket.write( _outbound.reader().peek() ) );
+        _outbound.reader().pop( socket.write( _outbound.reader().peek_all() ) );
       }
       if ( _outbound.reader().is_finished() ) {
         socket.shutdown( SHUT_WR );
@@ -107,7 +107,7 @@ void bidirectional_stream_copy( Socket& socket, string_view peer_name )
     Direction::Out,
     [&] {
       if ( _inbound.reader().bytes_buffered() ) {
-        _inbound.reader().pop( _output.write( _inbound.reader().peek() ) );
+        _inbound.reader().pop( _output.write( _inbound.reader().peek_all() ) );
       }
       if ( _inbound.reader().is_finished() ) {
         _output.close();
@@ -133,3 +133,78 @@ void bidirectional_stream_copy( Socket& socket, string_view peer_name )
     }
   }
 }
+
+void bidirectional_stream_copy( SPSCByteStream& outbound, SPSCByteStream& inbound, string_view peer_name )
+{
+  EventLoop _eventloop {};
+  FileDescriptor _input { STDIN_FILENO };
+  FileDescriptor _output { STDOUT_FILENO };
+  bool _outbound_shutdown { false };
+  bool _inbound_shutdown { false };
+
+  _input.set_blocking( false );
+  _output.set_blocking( false );
+
+  // rule 1: read from stdin into outbound stream
+  _eventloop.add_rule(
+    "read from stdin into outbound stream",
+    _input,
+    Direction::In,
+    [&] {
+      string data;
+      data.resize( outbound.available_capacity() );
+      _input.read( data );
+      outbound.push( data );
+      if ( _input.eof() ) {
+        outbound.close();
+        _outbound_shutdown = true;
+        cerr << "DEBUG: Outbound stream to " << peer_name << " finished.\n";
+      }
+    },
+    [&] { return not _outbound_shutdown and outbound.available_capacity() > 0; },
+    [&] {
+      outbound.close();
+      _outbound_shutdown = true;
+    } );
+
+  // rule 2: wait for room in a full outbound stream
+  _eventloop.add_rule(
+    "room in the outbound stream",
+    outbound.space_available_fd(),
+    Direction::In,
+    [&] { outbound.clear_space_available(); },
+    [&] { return not _outbound_shutdown and outbound.available_capacity() == 0; } );
+
+  // rule 3: wait for data in an empty inbound stream
+  _eventloop.add_rule(
+    "data in the inbound stream",
+    inbound.data_available_fd(),
+    Direction::In,
+    [&] { inbound.clear_data_available(); },
+    [&] { return not _inbound_shutdown and inbound.bytes_buffered() == 0 and not inbound.is_finished(); } );
+
+  // rule 4: read from inbound stream into stdout
+  _eventloop.add_rule(
+    "read from inbound stream into stdout",
+    _output,
+    Direction::Out,
+    [&] {
+      if ( inbound.bytes_buffered() ) {
+        inbound.pop( _output.write( inbound.peek() ) );
+      }
+      if ( inbound.is_finished() ) {
+        _output.close();
+        _inbound_shutdown = true;
+        cerr << "DEBUG: Inbound stream from " << peer_name << " finished.\n";
+      }
+    },
+    [&] { return not _inbound_shutdown and ( inbound.bytes_buffered() or inbound.is_finished() ); },
+    [&] { _inbound_shutdown = true; } );
+
+  // loop until completion
+  while ( true ) {
+    if ( EventLoop::Result::Exit == _eventloop.wait_next_event( -1 ) ) {
+      return;
+    }
+  }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "socket.hh"
+#include "spsc_byte_stream.hh"
 
 //! Copy socket input/output to stdin/stdout until finished
 void bidirectional_stream_copy( Socket& socket, std::string_view peer_name );
+
+//! Copy stdin into `outbound` and `inbound` to stdout until finished (e.g. for a TCPMinnowSocket)
+void bidirectional_stream_copy( SPSCByteStream& outbound, SPSCByteStream& inbound, std::string_view peer_name );
@@ -1,5 +1,6 @@
 #include "bidirectional_stream_copy.hh"
 #include "tcp_config.hh"
+#include "socket.hh"
 #include "tcp_minnow_socket.hh"
 #include "tun.hh"
 
@@ -9,8 +10,10 @@
 #include <iostream>
 #include <random>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <utility>
 
 using namespace std;
 
@@ -37,6 +40,9 @@ void show_usage( const char* argv0, const char* msg )
 
        << "   -d <tundev>     Connect to tun <tundev>                         " << TUN_DFLT << "\n\n"
 
+       << "   -u <port>       Carry datagrams over UDP from local <port>      (tun)\n"
+       << "   -U <host:port>  Far end of the UDP tunnel (required with -u)\n\n"
+
        << "   -Lu <loss>      Set uplink loss to <rate> (float in 0..1)       (no loss)\n"
        << "   -Ld <loss>      Set downlink loss to <rate> (float in 0..1)     (no loss)\n\n"
 
@@ -56,13 +62,21 @@ void check_argc( const span<char*>& args, size_t curr, const char* err )
   }
 }
 
-tuple<TCPConfig, FdAdapterConfig, bool, const char*> get_config( const span<char*>& args )
+//! Where the app sends its IPv4 datagrams: a TUN device, or a UDP tunnel to a peer
+struct LinkConfig
+{
+  const char* tundev = nullptr;
+  const char* udp_port = nullptr;
+  const char* udp_peer = nullptr;
+};
+
+tuple<TCPConfig, FdAdapterConfig, bool, LinkConfig> get_config( const span<char*>& args )
 {
   TCPConfig c_fsm {};
   c_fsm.isn = Wrap32 { random_device()() };
 
   FdAdapterConfig c_filt {};
-  const char* tundev = nullptr;
+  LinkConfig link {};
 
   size_t curr = 1;
   bool listen = false;
@@ -98,7 +112,17 @@ tuple<TCPConfig, FdAdapterConfig, bool, const char*> get_config( const span<char
 
     } else if ( strncmp( "-d", args[curr], 3 ) == 0 ) {
       check_argc( args, curr, "ERROR: -t requires one argument." );
-      tundev = args[curr + 1];
+      link.tundev = args[curr + 1];
+      curr += 2;
+
+    } else if ( strncmp( "-u", args[curr], 3 ) == 0 ) {
+      check_argc( args, curr, "ERROR: -u requires one argument." );
+      link.udp_port = args[curr + 1];
+      curr += 2;
+
+    } else if ( strncmp( "-U", args[curr], 3 ) == 0 ) {
+      check_argc( args, curr, "ERROR: -U requires one argument." );
+      link.udp_peer = args[curr + 1];
       curr += 2;
 
     } else if ( strncmp( "-Lu", args[curr], 3 ) == 0 ) {
@@ -127,6 +151,11 @@ tuple<TCPConfig, FdAdapterConfig, bool, const char*> get_config( const span<char
     }
   }
 
+  if ( ( link.udp_port == nullptr ) != ( link.udp_peer == nullptr ) ) {
+    show_usage( args[0], "ERROR: -u and -U must be given together." );
+    exit( 1 );
+  }
+
   // parse positional command-line arguments
   if ( listen ) {
     c_filt.source = { "0", args[curr + 1] };
@@ -139,7 +168,36 @@ tuple<TCPConfig, FdAdapterConfig, bool, const char*> get_config( const span<char
     c_filt.source = { source_address, source_port };
   }
 
-  return make_tuple( c_fsm, c_filt, listen, tundev );
+  return make_tuple( c_fsm, c_filt, listen, link );
+}
+
+//! Bind a UDP socket to the local port and connect it to the far end of the tunnel
+UDPSocket udp_tunnel( const LinkConfig& link )
+{
+  const string peer = link.udp_peer;
+  const auto colon = peer.rfind( ':' );
+  if ( colon == string::npos ) {
+    throw runtime_error( "-U expects <host:port>, got " + peer );
+  }
+
+  UDPSocket socket;
+  socket.bind( Address { "0", link.udp_port } );
+  socket.connect( Address { peer.substr( 0, colon ), peer.substr( colon + 1 ) } );
+  return socket;
+}
+
+template<class MinnowSocketT>
+void run( MinnowSocketT& tcp_socket, const TCPConfig& c_fsm, const FdAdapterConfig& c_filt, bool listen )
+{
+  if ( listen ) {
+    tcp_socket.listen_and_accept( c_fsm, c_filt );
+  } else {
+    tcp_socket.connect( c_fsm, c_filt );
+  }
+
+  bidirectional_stream_copy(
+    tcp_socket.outbound_stream(), tcp_socket.inbound_stream(), tcp_socket.peer_address().to_string() );
+  tcp_socket.wait_until_closed();
 }
 } // namespace
 
@@ -157,18 +215,18 @@ int main( int argc, char** argv )
       return EXIT_FAILURE;
     }
 
-    auto [c_fsm, c_filt, listen, tun_dev_name] = get_config( args );
-    LossyTCPOverIPv4MinnowSocket tcp_socket( LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>(
-      TCPOverIPv4OverTunFdAdapter( TunFD( tun_dev_name == nullptr ? TUN_DFLT : tun_dev_name ) ) ) );
+    auto [c_fsm, c_filt, listen, link] = get_config( args );
 
-    if ( listen ) {
-      tcp_socket.listen_and_accept( c_fsm, c_filt );
+    // A UDP socket takes each burst of segments in one sendmmsg; a TUN device takes one packet per write
+    if ( link.udp_port != nullptr ) {
+      LossyTCPOverIPv4OverUDPMinnowSocket tcp_socket(
+        LossyFdAdapter<TCPOverIPv4OverUDPFdAdapter>( TCPOverIPv4OverUDPFdAdapter( udp_tunnel( link ) ) ) );
+      run( tcp_socket, c_fsm, c_filt, listen );
     } else {
-      tcp_socket.connect( c_fsm, c_filt );
+      LossyTCPOverIPv4MinnowSocket tcp_socket( LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>(
+        TCPOverIPv4OverTunFdAdapter( TunFD( link.tundev == nullptr ? TUN_DFLT : link.tundev ) ) ) );
+      run( tcp_socket, c_fsm, c_filt, listen );
     }
-
-    bidirectional_stream_copy( tcp_socket, tcp_socket.peer_address().to_string() );
-    tcp_socket.wait_until_closed();
   } catch ( const exception& e ) {
     cerr << "Exception: " << e.what() << endl;
     return EXIT_FAILURE;
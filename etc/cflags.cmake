@@ -6,3 +6,8 @@ set(SANITIZING_FLAGS -fno-sanitize-recover=all -fsanitize=undefined -fsanitize=a
 # ask for more warnings from the compiler
 set (CMAKE_BASE_CXX_FLAGS "${CMAKE_CXX_FLAGS}")
 set (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wpedantic -Wextra -Weffc++ -Werror -Wshadow -Wpointer-arith -Wcast-qual -Wformat=2 -Wno-unqualified-std-cast-call -Wno-non-virtual-dtor")
+
+option (MINNOW_INSTRUMENT "Count allocations and copies in ByteStream and Reassembler" OFF)
+if (MINNOW_INSTRUMENT)
+  add_compile_definitions (MINNOW_INSTRUMENT)
+endif ()
@@ -23,6 +23,8 @@ ttest(byte_stream_one_write)
 ttest(byte_stream_two_writes)
 ttest(byte_stream_many_writes)
 ttest(byte_stream_stress_test)
+ttest(byte_stream_spsc)
+ttest(minnow_socket_spsc)
 
 ttest(reassembler_single)
 ttest(reassembler_cap)
@@ -31,6 +33,7 @@ ttest(reassembler_dup)
 ttest(reassembler_holes)
 ttest(reassembler_overlapping)
 ttest(reassembler_win)
+ttest(reassembler_pressure)
 
 ttest(wrapping_integers_cmp)
 ttest(wrapping_integers_wrap)
@@ -45,6 +48,9 @@ ttest(recv_reorder)
 ttest(recv_reorder_more)
 ttest(recv_close)
 ttest(recv_special)
+ttest(recv_sack)
+ttest(recv_window_scale)
+ttest(recv_timestamps)
 
 ttest(send_connect)
 ttest(send_transmit)
@@ -53,6 +59,24 @@ ttest(send_window)
 ttest(send_ack)
 ttest(send_close)
 ttest(send_extra)
+ttest(send_congestion)
+ttest(send_rtt)
+ttest(send_fast_retx)
+ttest(send_ring)
+ttest(send_pacing)
+ttest(send_nagle)
+ttest(send_mss)
+ttest(send_window_scale)
+ttest(send_timestamps)
+ttest(send_rack_tlp)
+ttest(send_sack)
+ttest(send_persist)
+ttest(peer_dup_ack)
+ttest(peer_delayed_ack)
+ttest(peer_batch)
+ttest(adapter_batch)
+ttest(peer_info)
+ttest(peer_window_update)
 
 ttest(net_interface)
 
@@ -1,42 +1,65 @@
 #include "byte_stream.hh"
 #include <algorithm>
+#include <bit>
 #include <utility>
 
 using namespace std;
 
 ByteStream::ByteStream( uint64_t capacity ) : capacity_( capacity ) {}
 
+void ByteStream::copy_in( uint64_t stream_index, std::string_view data )
+{
+  const uint64_t offset = stream_index & ( buffer_.size() - 1 );
+  const uint64_t first_part = std::min<uint64_t>( data.size(), buffer_.size() - offset );
+
+  std::copy_n( data.begin(), first_part, buffer_.begin() + offset );
+  std::copy( data.begin() + first_part, data.end(), buffer_.begin() ); //绕回开头
+}
+
+void ByteStream::grow_buffer( uint64_t min_size )
+{
+  if ( buffer_.size() >= min_size )
+    return;
+
+  std::string old_buffer = std::exchange( buffer_, std::string( std::bit_ceil( min_size ), '\0' ) );
+  instrument_count( stats_.buffer_allocations );
+
+  if ( old_buffer.empty() )
+    return;
+
+  //按原位置拷贝已缓冲的字节 (最多两段)
+  const uint64_t buffered = pushed_bytes_counter_ - popped_bytes_counter_;
+  const uint64_t offset = popped_bytes_counter_ & ( old_buffer.size() - 1 );
+  const uint64_t first_part = std::min<uint64_t>( buffered, old_buffer.size() - offset );
+  const std::string_view old_view { old_buffer };
+
+  copy_in( popped_bytes_counter_, old_view.substr( offset, first_part ) );
+  copy_in( popped_bytes_counter_ + first_part, old_view.substr( 0, buffered - first_part ) );
+}
+
 bool Writer::is_closed() const
 {
     return is_closed_;
 }
 
-void Writer::push( string data )
-{ 
-    (void)data;
-  
-    if (is_closed() == true)
-    {
-        set_error();
-        return;
-    }
-    
-
-    if (available_capacity() == 0 || data.empty() )
-        return;
+void Writer::push( string_view data )
+{
+  if ( is_closed() == true ) {
+    set_error();
+    return;
+  }
 
-    const auto push_len = std::min(available_capacity(), data.size() );
+  if ( available_capacity() == 0 || data.empty() )
+    return;
 
-    if (data.size() > push_len)
-    {
-        data = data.substr(0, push_len); //截断
-    }
+  const auto push_len = std::min( available_capacity(), data.size() );
 
-    buffer_deque_.push_back(std::move(data) ) ; //将数据推送到缓冲区
-    view_deque_.emplace_back(buffer_deque_.back().c_str(), push_len); //
+  grow_buffer( pushed_bytes_counter_ - popped_bytes_counter_ + push_len );
+  copy_in( pushed_bytes_counter_, data.substr( 0, push_len ) ); //截断
 
-    buffered_bytes_counter_ += push_len;
-    pushed_bytes_counter_ += push_len;
+  pushed_bytes_counter_ += push_len;
+  instrument_count( stats_.bytes_copied_in, push_len );
+  instrument_count( stats_.pushes );
 }
 
 void Writer::close()
@@ -46,7 +69,7 @@ void Writer::close()
 
 uint64_t Writer::available_capacity() const
 {
-    return capacity_ - buffered_bytes_counter_;
+  return capacity_ - ( pushed_bytes_counter_ - popped_bytes_counter_ );
 }
 
 uint64_t Writer::bytes_pushed() const
@@ -66,49 +89,53 @@ uint64_t Reader::bytes_popped() const
 
 std::string_view Reader::peek() const
 {
-    if (view_deque_.empty() )
-        return {};
+  const uint64_t buffered = bytes_buffered();
+  if ( buffered == 0 )
+    return {};
 
-    return view_deque_.front();
+  //从读位置到缓冲区末尾 (或数据末尾) 的连续区域
+  const uint64_t offset = popped_bytes_counter_ & ( buffer_.size() - 1 );
+  return { buffer_.data() + offset, std::min<uint64_t>( buffered, buffer_.size() - offset ) };
 }
 
-void Reader::pop( uint64_t len )
+std::vector<std::string_view> Reader::peek_all() const
 {
-    (void)len;
-
-    auto pop_len = std::min(len, buffered_bytes_counter_);
-
-    while (pop_len > 0)
-    {
-        if (view_deque_.empty() )   return;
-
-        auto sz = view_deque_.front().size();
-
-        if (pop_len < sz) //
-        {
-            view_deque_.front().remove_prefix(pop_len); 
-            //无需对buffer_queue更改
-
-            buffered_bytes_counter_ -= pop_len;
-            popped_bytes_counter_ += pop_len;
+  std::vector<std::string_view> segments;
+  const std::string_view front = peek();
+  if ( front.empty() )
+    return segments;
+
+  segments.push_back( front );
+  if ( front.size() < bytes_buffered() ) //数据绕回了缓冲区开头
+  {
+    segments.emplace_back( buffer_.data(), bytes_buffered() - front.size() );
+  }
+
+  return segments;
+}
 
-            return;
-        }
+void Reader::pop( uint64_t len )
+{
+  len = std::min( len, bytes_buffered() );
+  popped_bytes_counter_ += len;
+  instrument_count( stats_.pops, len > 0 );
+}
 
-        else // pop_len > sz
-        {
-            view_deque_.pop_front();
-            buffer_deque_.pop_front();
+std::string Reader::pop_chunk( uint64_t len )
+{
+  std::string chunk;
+  chunk.reserve( std::min( len, bytes_buffered() ) ); //只分配一次
 
-            pop_len = pop_len - sz; //更新pop_len
+  for ( const auto segment : peek_all() ) {
+    chunk += segment.substr( 0, len - chunk.size() );
+  }
 
-            buffered_bytes_counter_ -= sz;
-            popped_bytes_counter_ += sz;
-        }
-    }
+  pop( chunk.size() );
+  instrument_count( stats_.bytes_copied_out, chunk.size() );
+  return chunk;
 }
 
 uint64_t Reader::bytes_buffered() const
 {
-    return buffered_bytes_counter_;
+  return pushed_bytes_counter_ - popped_bytes_counter_;
 }
@@ -1,17 +1,28 @@
 #pragma once
 
+#include "instrumentation.hh"
+
 #include <cstdint>
 #include <string>
 #include <string_view>
 
 #include <algorithm>
-#include <deque>
 #include <utility>
-
+#include <vector>
 
 class Reader;
 class Writer;
 
+// Allocation and copy counters; only updated when built with MINNOW_INSTRUMENT
+struct ByteStreamStats
+{
+  uint64_t buffer_allocations {}; // times the ring buffer was (re)allocated
+  uint64_t bytes_copied_in {};    // bytes copied into the ring buffer by push()
+  uint64_t bytes_copied_out {};   // bytes copied out of the ring buffer by pop_chunk()
+  uint64_t pushes {};             // push() calls that stored at least one byte
+  uint64_t pops {};               // pop() calls that removed at least one byte
+};
+
 class ByteStream
 {
 public:
@@ -26,25 +37,32 @@ public:
   void set_error() { error_ = true; };       // Signal that the stream suffered an error.
   bool has_error() const { return error_; }; // Has the stream had an error?
 
+  const ByteStreamStats& stats() const { return stats_; } // Instrumentation counters
+
 protected:
   // Please add any additional state to the ByteStream here, and not to the Writer and Reader interfaces.
   uint64_t capacity_;
   bool error_ {};
   bool is_closed_{false};
-  
-  std::deque<std::string> buffer_deque_{};
-  std::deque<std::string_view> view_deque_{};
+
+  // Ring buffer: the byte at stream index i lives at buffer_[i & (buffer_.size() - 1)].
+  // Its size is zero or a power of two, grown on demand (never past bit_ceil(capacity_)),
+  // so a stream in steady state pushes and pops without touching the allocator.
+  std::string buffer_ {};
 
   uint64_t pushed_bytes_counter_ {0};
-  uint64_t buffered_bytes_counter_ {0};
-  uint64_t popped_bytes_counter_ {0}; 
+  uint64_t popped_bytes_counter_ { 0 };
+
+  ByteStreamStats stats_ {};
 
+  void grow_buffer( uint64_t min_size );                        // make room for `min_size` buffered bytes
+  void copy_in( uint64_t stream_index, std::string_view data ); // write `data` at its ring position
 };
 
 class Writer : public ByteStream
 {
 public:
-  void push( std::string data ); // Push data to stream, but only as much as available capacity allows.
+  void push( std::string_view data ); // Push data to stream, but only as much as available capacity allows.
   void close();                  // Signal that the stream has reached its ending. Nothing more will be written.
 
   bool is_closed() const;              // Has the stream been closed?
@@ -56,7 +74,9 @@ class Reader : public ByteStream
 {
 public:
   std::string_view peek() const; // Peek at the next bytes in the buffer
+  std::vector<std::string_view> peek_all() const; // Peek at every buffered byte, as writev-ready segments
   void pop( uint64_t len );      // Remove `len` bytes from the buffer
+  std::string pop_chunk( uint64_t len ); // Remove up to `len` bytes from the buffer and return them
   bool is_finished() const;        // Is the stream finished (closed and fully popped)?
   uint64_t bytes_buffered() const; // Number of bytes currently buffered (pushed and not popped)SS
   uint64_t bytes_popped() const;   // Total number of bytes cumulatively popped from stream
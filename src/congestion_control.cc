@@ -0,0 +1,117 @@
+#include "congestion_control.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// RFC 5681's initial window: at most four segments, at least two
+uint64_t initial_window( uint64_t mss )
+{
+  return min( 4 * mss, max<uint64_t>( 2 * mss, 4380 ) );
+}
+
+} // namespace
+
+unique_ptr<CongestionControl> make_congestion_control( CongestionControlAlgorithm algorithm, uint64_t mss )
+{
+  switch ( algorithm ) {
+    case CongestionControlAlgorithm::NewReno:
+      return make_unique<NewReno>( mss );
+    case CongestionControlAlgorithm::Cubic:
+      return make_unique<Cubic>( mss );
+    case CongestionControlAlgorithm::None:
+      break;
+  }
+  return make_unique<NoCongestionControl>( mss );
+}
+
+NewReno::NewReno( uint64_t mss ) : CongestionControl( mss ), cwnd_( initial_window( mss ) ) {}
+
+void NewReno::on_ack( uint64_t bytes_acked, uint64_t /* now_ms */ )
+{
+  if ( cwnd_ < ssthresh_ ) {
+    cwnd_ += min( bytes_acked, mss_ );
+    return;
+  }
+
+  bytes_acked_in_avoidance_ += bytes_acked;
+  if ( bytes_acked_in_avoidance_ >= cwnd_ ) {
+    bytes_acked_in_avoidance_ -= cwnd_;
+    cwnd_ += mss_;
+  }
+}
+
+void NewReno::on_loss( uint64_t bytes_in_flight, uint64_t /* now_ms */ )
+{
+  ssthresh_ = max( bytes_in_flight / 2, 2 * mss_ );
+  cwnd_ = ssthresh_;
+  bytes_acked_in_avoidance_ = 0;
+}
+
+void NewReno::on_rto( uint64_t bytes_in_flight, uint64_t /* now_ms */ )
+{
+  ssthresh_ = max( bytes_in_flight / 2, 2 * mss_ );
+  cwnd_ = mss_;
+  bytes_acked_in_avoidance_ = 0;
+}
+
+Cubic::Cubic( uint64_t mss ) : CongestionControl( mss ), cwnd_( static_cast<double>( initial_window( mss ) ) ) {}
+
+void Cubic::on_ack( uint64_t bytes_acked, uint64_t now_ms )
+{
+  const double mss = static_cast<double>( mss_ );
+  const double acked = static_cast<double>( bytes_acked );
+
+  if ( cwnd_ < static_cast<double>( ssthresh_ ) ) {
+    cwnd_ += min( acked, mss );
+    return;
+  }
+
+  if ( not epoch_started_ ) {
+    epoch_started_ = true;
+    epoch_start_ms_ = now_ms;
+    w_est_ = cwnd_;
+    if ( w_max_ <= cwnd_ ) {
+      w_max_ = cwnd_;
+      k_ = 0;
+    } else {
+      k_ = cbrt( ( w_max_ - cwnd_ ) / mss / C );
+    }
+  }
+
+  // W_cubic(t) = C * (t - K)^3 + W_max, aiming no more than 50% above the current window
+  const double t = static_cast<double>( now_ms - epoch_start_ms_ ) / 1000.0;
+  const double target = clamp( w_max_ + C * pow( t - k_, 3 ) * mss, cwnd_, 1.5 * cwnd_ );
+
+  // Reno-friendly region: grow at least as fast as standard TCP would with the same beta
+  w_est_ += mss * ( 3 * ( 1 - BETA ) / ( 1 + BETA ) ) * acked / cwnd_;
+
+  if ( w_est_ > target ) {
+    cwnd_ = max( cwnd_, w_est_ );
+  } else {
+    cwnd_ += ( target - cwnd_ ) * acked / cwnd_;
+  }
+}
+
+void Cubic::reduce()
+{
+  // Fast convergence: if this loss came before regaining the last peak, release bandwidth sooner
+  w_max_ = cwnd_ < w_max_ ? cwnd_ * ( 1 + BETA ) / 2 : cwnd_;
+  ssthresh_ = max( static_cast<uint64_t>( cwnd_ * BETA ), 2 * mss_ );
+  epoch_started_ = false;
+}
+
+void Cubic::on_loss( uint64_t /* bytes_in_flight */, uint64_t /* now_ms */ )
+{
+  reduce();
+  cwnd_ = static_cast<double>( ssthresh_ );
+}
+
+void Cubic::on_rto( uint64_t /* bytes_in_flight */, uint64_t /* now_ms */ )
+{
+  reduce();
+  cwnd_ = static_cast<double>( mss_ );
+}
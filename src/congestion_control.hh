@@ -0,0 +1,104 @@
+#pragma once
+
+#include "tcp_config.hh"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+/*
+ * A congestion controller decides how many sequence numbers the TCPSender may have in flight
+ * (the congestion window, cwnd). The sender never lets more than min(receiver's window, cwnd)
+ * be outstanding, and reports what happens to its segments through the hooks below.
+ *
+ * All byte counts are in sequence numbers; `now_ms` is the sender's clock (the sum of all ticks).
+ */
+class CongestionControl
+{
+public:
+  explicit CongestionControl( uint64_t mss ) : mss_( mss ) {}
+  virtual ~CongestionControl() = default;
+
+  CongestionControl( const CongestionControl& ) = delete;
+  CongestionControl& operator=( const CongestionControl& ) = delete;
+
+  virtual uint64_t cwnd() const = 0;     // Congestion window, in sequence numbers
+  virtual uint64_t ssthresh() const = 0; // Slow-start threshold, in sequence numbers
+
+  // `bytes_acked` new sequence numbers were cumulatively acknowledged
+  virtual void on_ack( uint64_t bytes_acked, uint64_t now_ms ) = 0;
+
+  // A loss was detected without a timeout (e.g. by duplicate ACKs) with `bytes_in_flight` outstanding
+  virtual void on_loss( uint64_t bytes_in_flight, uint64_t now_ms ) = 0;
+
+  // The retransmission timer expired with `bytes_in_flight` outstanding
+  virtual void on_rto( uint64_t bytes_in_flight, uint64_t now_ms ) = 0;
+
+  uint64_t mss() const { return mss_; }
+  void set_mss( uint64_t mss ) { mss_ = mss; } // The sender's segment size changed (MSS option or PMTU probe)
+
+protected:
+  uint64_t mss_;
+};
+
+// Construct the controller for `algorithm`, sized for segments of `mss` bytes
+std::unique_ptr<CongestionControl> make_congestion_control( CongestionControlAlgorithm algorithm, uint64_t mss );
+
+// No congestion control: the receiver's window is the only limit.
+class NoCongestionControl : public CongestionControl
+{
+public:
+  using CongestionControl::CongestionControl;
+
+  uint64_t cwnd() const override { return std::numeric_limits<uint64_t>::max(); }
+  uint64_t ssthresh() const override { return std::numeric_limits<uint64_t>::max(); }
+  void on_ack( uint64_t, uint64_t ) override {}
+  void on_loss( uint64_t, uint64_t ) override {}
+  void on_rto( uint64_t, uint64_t ) override {}
+};
+
+// NewReno (RFC 5681): exponential slow start, then one MSS per window of ACKed data.
+class NewReno : public CongestionControl
+{
+public:
+  explicit NewReno( uint64_t mss );
+
+  uint64_t cwnd() const override { return cwnd_; }
+  uint64_t ssthresh() const override { return ssthresh_; }
+  void on_ack( uint64_t bytes_acked, uint64_t now_ms ) override;
+  void on_loss( uint64_t bytes_in_flight, uint64_t now_ms ) override;
+  void on_rto( uint64_t bytes_in_flight, uint64_t now_ms ) override;
+
+private:
+  uint64_t cwnd_;
+  uint64_t ssthresh_ { std::numeric_limits<uint64_t>::max() };
+  uint64_t bytes_acked_in_avoidance_ {}; // ACKed bytes not yet turned into cwnd growth
+};
+
+// CUBIC (RFC 9438): after a loss, the window follows a cubic function of the time since the
+// loss, flattening out around the window where the loss happened.
+class Cubic : public CongestionControl
+{
+public:
+  explicit Cubic( uint64_t mss );
+
+  uint64_t cwnd() const override { return static_cast<uint64_t>( cwnd_ ); }
+  uint64_t ssthresh() const override { return ssthresh_; }
+  void on_ack( uint64_t bytes_acked, uint64_t now_ms ) override;
+  void on_loss( uint64_t bytes_in_flight, uint64_t now_ms ) override;
+  void on_rto( uint64_t bytes_in_flight, uint64_t now_ms ) override;
+
+  static constexpr double C = 0.4;    // Scaling constant, in segments per second cubed
+  static constexpr double BETA = 0.7; // Multiplicative decrease factor
+
+private:
+  double cwnd_;     // in bytes, kept fractional so small increments accumulate
+  double w_max_ {}; // window just before the last reduction, in bytes
+  double w_est_ {}; // Reno-friendly window estimate, in bytes
+  double k_ {};     // seconds it takes the cubic to climb back to w_max_
+  uint64_t ssthresh_ { std::numeric_limits<uint64_t>::max() };
+  bool epoch_started_ {}; // has congestion avoidance started since the last reduction?
+  uint64_t epoch_start_ms_ {};
+
+  void reduce();
+};
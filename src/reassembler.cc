@@ -1,11 +1,15 @@
 #include "reassembler.hh"
 
+#include <array>
+#include <bit>
+
 void Reassembler::insert(uint64_t first_index, std::string data, bool is_last_substring)
 {
-    if ( is_last_substring == true )
-    {
-        is_last_ = true;
-        end_index_ = first_index + data.size();
+  instrument_count( stats_.segments_inserted );
+
+  if ( is_last_substring == true ) {
+    is_last_ = true;
+    end_index_ = first_index + data.size();
     }
 
     if ( data.empty() )
@@ -23,6 +27,17 @@ void Reassembler::insert(uint64_t first_index, std::string data, bool is_last_su
         return;
     }
 
+    // fast path: the next in-order bytes with nothing held, straight to the output
+    if ( first_index == output_.writer().bytes_pushed() and held_ranges_.empty() ) {
+      instrument_count( stats_.fast_path_hits );
+      output_.writer().push( data ); // push() keeps only what fits
+
+      if ( is_last_ == true and output_.writer().bytes_pushed() == end_index_ ) {
+        output_.writer().close();
+      }
+      return;
+    }
+
     first_unassembled_index_ = output_.writer().bytes_pushed();
     first_unaccepted_index_ = first_unassembled_index_ + output_.writer().available_capacity();
 
@@ -32,85 +47,150 @@ void Reassembler::insert(uint64_t first_index, std::string data, bool is_last_su
         return;
     }
 
-    //handle overlapping with pushed
+    // clip to the window [first_unassembled_index_, first_unaccepted_index_)
+    std::string_view view { data };
     if ( first_index < first_unassembled_index_ )
     {
-        data.erase(0, first_unassembled_index_ - first_index);
-        first_index = first_unassembled_index_;
+      view.remove_prefix( first_unassembled_index_ - first_index );
+      first_index = first_unassembled_index_;
     }
+    view = view.substr( 0, first_unaccepted_index_ - first_index );
 
-    //remove the unaccepted bytes
-    if ( first_index + data.size() >= first_unaccepted_index_ )
-    {
-        data.resize(first_unaccepted_index_ - first_index);
-        is_last_substring = false; //not fininshed
-    }
+    uint64_t range_first = first_index;
+    uint64_t range_end = first_index + view.size(); // one past the last index
 
-    auto last_index = first_index + data.size() - 1; //the right bound
+    grow_window( range_end - first_unassembled_index_ );
 
-    //handle the left overlapping
-    auto left_it = buffer_map_.upper_bound( first_index );
-    if ( left_it != buffer_map_.begin() ) //not the first element but can be not found(return the end iter)
-    {
-        auto prev = std::prev( left_it );
-        //left overlapping
-        if ( prev->first + prev->second.size() - 1 >= first_index )
-        {
-            //data is fully overlapped
-            if ( prev->first + prev->second.size() - 1 >= last_index )
-            {
-                return;
-            }
-
-            data = prev->second.substr( 0, first_index - prev->first ) + data; //merge
-            first_index = prev->first;
-            pending_bytes_counter_ -= prev->second.size();
-            buffer_map_.erase(prev);
-        }
+    // start from the held range that overlaps or touches range_first (if any)
+    auto it = held_ranges_.upper_bound( range_first );
+    if ( it != held_ranges_.begin() and std::prev( it )->second.end >= range_first ) {
+      --it;
     }
 
-    //handle right overlapping
-    auto right_it = buffer_map_.upper_bound( last_index );
-    if ( right_it != buffer_map_.begin() )
-    {
-        auto prev = std::prev( right_it );
-        if ( last_index <= prev->first + prev->second.size() - 1 )
-        {
-            data += prev->second.substr( last_index - prev->first + 1 ); //!!
-            last_index = prev->first + prev->second.size() - 1;
-        }
+    // copy only the gaps between held ranges, absorbing every range that overlaps or touches
+    uint64_t cursor = first_index;
+    while ( it != held_ranges_.end() and it->first <= range_end ) {
+      if ( it->first > cursor ) {
+        copy_to_window( cursor, view.substr( cursor - first_index, it->first - cursor ) );
+      }
+      cursor = std::max( cursor, it->second.end );
+
+      range_first = std::min( range_first, it->first );
+      range_end = std::max( range_end, it->second.end );
+      pending_bytes_counter_ -= it->second.end - it->first;
+      instrument_count( stats_.chunk_merges );
+      it = held_ranges_.erase( it );
     }
 
-    while ( left_it != right_it )
-    {
-        pending_bytes_counter_ -= left_it->second.size();
-        left_it = buffer_map_.erase( left_it );
-    } //erase [left_it, right_it)
+    const uint64_t view_end = first_index + view.size();
+    if ( cursor < view_end ) {
+      copy_to_window( cursor, view.substr( cursor - first_index ) );
+    }
 
-    pending_bytes_counter_ += data.size();
-    buffer_map_.emplace_hint(left_it, first_index, std::move( data ) );
+    held_ranges_.emplace_hint( it, range_first, HeldRange { range_end, ++update_clock_ } );
+    pending_bytes_counter_ += range_end - range_first;
+    instrument_count( stats_.map_nodes_created );
 
     //check the bytes after
-    while ( not buffer_map_.empty() )
-    {
-        auto it = buffer_map_.begin();
-        if ( it->first != output_.writer().bytes_pushed() )
-        {
-            break;
-        }
+    push_held_prefix();
+    enforce_range_limit();
 
-        pending_bytes_counter_ -= it->second.size();
-        output_.writer().push( it->second );
-        buffer_map_.erase(it);
+    if ( is_last_ == true and output_.writer().bytes_pushed() == end_index_ ) {
+      output_.writer().close();
     }
+}
 
-    if ( is_last_ == true and output_.writer().bytes_pushed() == end_index_ )
-    {
-        output_.writer().close();
+void Reassembler::grow_window( uint64_t min_size )
+{
+  if ( window_.size() >= min_size ) {
+    return;
+  }
+
+  std::string old_window = std::exchange( window_, std::string( std::bit_ceil( min_size ), '\0' ) );
+  instrument_count( stats_.allocations );
+
+  // re-home every held byte at its position in the larger ring
+  for ( const auto& [first, range] : held_ranges_ ) {
+    for ( uint64_t index = first; index < range.end; ) {
+      const uint64_t offset = index & ( old_window.size() - 1 );
+      const uint64_t len = std::min( range.end - index, old_window.size() - offset );
+      copy_to_window( index, std::string_view( old_window ).substr( offset, len ) );
+      index += len;
+    }
+  }
+}
+
+void Reassembler::copy_to_window( uint64_t first_index, std::string_view data )
+{
+  const uint64_t offset = first_index & ( window_.size() - 1 );
+  const uint64_t first_part = std::min<uint64_t>( data.size(), window_.size() - offset );
+
+  std::copy_n( data.begin(), first_part, window_.begin() + offset );
+  std::copy( data.begin() + first_part, data.end(), window_.begin() ); // wrap around
+  instrument_count( stats_.bytes_copied, data.size() );
+}
+
+void Reassembler::push_held_prefix()
+{
+  if ( held_ranges_.empty() or held_ranges_.begin()->first != output_.writer().bytes_pushed() ) {
+    return;
+  }
+
+  const uint64_t first = held_ranges_.begin()->first;
+  const uint64_t end = held_ranges_.begin()->second.end;
+  held_ranges_.erase( held_ranges_.begin() );
+  pending_bytes_counter_ -= end - first;
+
+  // at most two pieces: up to the end of the ring, then from its start
+  const uint64_t offset = first & ( window_.size() - 1 );
+  const uint64_t first_part = std::min( end - first, window_.size() - offset );
+  const std::string_view window_view { window_ };
+
+  output_.writer().push( window_view.substr( offset, first_part ) );
+  output_.writer().push( window_view.substr( 0, end - first - first_part ) );
+}
+
+void Reassembler::enforce_range_limit()
+{
+  if ( max_held_ranges_ == 0 ) {
+    return;
+  }
+
+  // the farthest range from first_unassembled_index_ is the least useful to keep
+  while ( held_ranges_.size() > max_held_ranges_ ) {
+    const auto farthest = std::prev( held_ranges_.end() );
+    const uint64_t len = farthest->second.end - farthest->first;
+
+    pending_bytes_counter_ -= len;
+    bytes_dropped_ += len;
+    ++ranges_dropped_;
+    held_ranges_.erase( farthest );
+  }
+}
+
+size_t Reassembler::recent_ranges( std::span<std::pair<uint64_t, uint64_t>> ranges ) const
+{
+  // one insertion pass keeps the newest `capacity` ranges in order, so this is O(held ranges)
+  std::array<uint64_t, MAX_RECENT_RANGES> updates {};
+  const size_t capacity = std::min( ranges.size(), MAX_RECENT_RANGES );
+  size_t count = 0;
+  for ( const auto& [first, range] : held_ranges_ ) {
+    size_t slot = count < capacity ? count++ : capacity;
+    for ( ; slot > 0 and updates[slot - 1] < range.last_update; --slot ) {
+      if ( slot < capacity ) { // an older range moves down; the oldest falls off the end
+        updates[slot] = updates[slot - 1];
+        ranges[slot] = ranges[slot - 1];
+      }
     }
+    if ( slot < capacity ) {
+      updates[slot] = range.last_update;
+      ranges[slot] = { first, range.end };
+    }
+  }
+  return count;
 }
 
 uint64_t Reassembler::bytes_pending() const
 {
     return pending_bytes_counter_;
-}
\ No newline at end of file
+}
@@ -1,8 +1,22 @@
 #pragma once
 #include <map>
 #include <algorithm>
+#include <span>
+#include <utility>
 
 #include "byte_stream.hh"
+#include "instrumentation.hh"
+
+// Memory-churn counters; only updated when built with MINNOW_INSTRUMENT
+struct ReassemblerStats
+{
+  uint64_t segments_inserted { 0 }; // calls to insert()
+  uint64_t fast_path_hits { 0 };    // in-order inserts pushed straight to the output
+  uint64_t allocations { 0 };       // times the window buffer was (re)allocated
+  uint64_t bytes_copied { 0 };      // bytes copied into the window buffer
+  uint64_t map_nodes_created { 0 }; // held ranges created in held_ranges_
+  uint64_t chunk_merges { 0 };      // held ranges absorbed into a wider one
+};
 
 class Reassembler
 {
@@ -10,7 +24,12 @@ public:
 	// Construct Reassembler to write into given ByteStream.
 	explicit Reassembler(ByteStream&& output) : output_(std::move(output)) {}
 
-	/*
+        // Construct Reassembler that holds at most `max_held_ranges` out-of-order ranges (0 means no limit).
+        Reassembler( ByteStream&& output, uint64_t max_held_ranges )
+          : output_( std::move( output ) ), max_held_ranges_( max_held_ranges )
+        {}
+
+        /*
 	 * Insert a new substring to be reassembled into a ByteStream.
 	 *   `first_index`: the index of the first byte of the substring
 	 *   `data`: the substring itself
@@ -36,7 +55,22 @@ public:
 	// How many bytes are stored in the Reassembler itself?
 	uint64_t bytes_pending() const;
 
-	// Access output stream reader
+        // Memory-pressure policy: when more than max_held_ranges() out-of-order ranges would be held,
+        // the ranges farthest from the next needed byte are dropped (the sender will retransmit them).
+        uint64_t max_held_ranges() const { return max_held_ranges_; }
+        uint64_t held_ranges() const { return held_ranges_.size(); } // How many disjoint ranges are held now?
+        uint64_t ranges_dropped() const { return ranges_dropped_; }  // How many held ranges were dropped?
+        uint64_t bytes_dropped() const { return bytes_dropped_; }    // How many held bytes were dropped?
+
+        // Fill `ranges` with up to MAX_RECENT_RANGES held [first, end) index ranges, most recently
+        // updated first (for SACK); returns how many it filled. Does not allocate.
+        static constexpr size_t MAX_RECENT_RANGES = 4;
+        size_t recent_ranges( std::span<std::pair<uint64_t, uint64_t>> ranges ) const;
+
+        // Instrumentation counters
+        const ReassemblerStats& stats() const { return stats_; }
+
+        // Access output stream reader
 	Reader& reader() { return output_.reader(); }
 	const Reader& reader() const { return output_.reader(); }
 
@@ -50,5 +84,26 @@ private:
 	uint64_t pending_bytes_counter_{ 0 };
 	uint64_t is_last_{ false };
 	uint64_t end_index_{ 0 };
-	std::map<uint64_t, std::string> buffer_map_{};
+        uint64_t max_held_ranges_ { 0 };
+        uint64_t ranges_dropped_ { 0 };
+        uint64_t bytes_dropped_ { 0 };
+        ReassemblerStats stats_ {};
+
+        // Out-of-order bytes are copied once into a window-sized ring buffer: stream index i lives at
+        // window_[i & (window_.size() - 1)]. Which indices are present is kept as a set of disjoint,
+        // non-adjacent ranges, so an insert costs O(new bytes) no matter how much it overlaps.
+        struct HeldRange
+        {
+          uint64_t end;         // one past the last index
+          uint64_t last_update; // value of update_clock_ when this range last grew
+        };
+
+        std::string window_ {};
+        std::map<uint64_t, HeldRange> held_ranges_{}; // first index -> range
+        uint64_t update_clock_ { 0 };
+
+        void grow_window( uint64_t min_size );
+        void copy_to_window( uint64_t first_index, std::string_view data );
+        void push_held_prefix();    // hand the range starting at first_unassembled_index_ to the output
+        void enforce_range_limit(); // drop the farthest ranges until within max_held_ranges_
 };
\ No newline at end of file
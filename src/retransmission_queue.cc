@@ -0,0 +1,48 @@
+#include "retransmission_queue.hh"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+void RetransmissionQueue::grow()
+{
+  vector<OutstandingSegment> bigger( max<size_t>( 16, ring_.size() * 2 ) );
+  for ( size_t i = 0; i < size_; ++i ) {
+    bigger[i] = std::move( ( *this )[i] );
+  }
+  ring_ = std::move( bigger );
+  head_ = 0;
+}
+
+void RetransmissionQueue::push_back( OutstandingSegment&& segment )
+{
+  if ( size_ == ring_.size() ) {
+    grow();
+  }
+  ( *this )[size_] = std::move( segment );
+  ++size_;
+}
+
+void RetransmissionQueue::pop_front()
+{
+  front().msg.payload = {};
+  head_ = ( head_ + 1 ) & ( ring_.size() - 1 );
+  --size_;
+}
+
+size_t RetransmissionQueue::lower_bound( uint64_t abs_seqno ) const
+{
+  // segments are kept in seqno order, so binary-search the ring
+  size_t low = 0;
+  size_t high = size_;
+  while ( low < high ) {
+    const size_t mid = low + ( high - low ) / 2;
+    if ( ( *this )[mid].abs_seqno < abs_seqno ) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
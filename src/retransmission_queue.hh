@@ -0,0 +1,50 @@
+#pragma once
+
+#include "tcp_sender_message.hh"
+
+#include <cstdint>
+#include <vector>
+
+// One transmitted segment that has not been fully acknowledged yet
+struct OutstandingSegment
+{
+  uint64_t abs_seqno {};       // absolute sequence number of the segment's first seqno
+  TCPSenderMessage msg {};     // the segment as sent (owns the payload)
+  uint64_t sent_ms {};         // sender clock when it was last (re)transmitted
+  bool retransmitted {};       // retransmitted segments are not RTT samples (Karn's algorithm)
+  bool sacked {};              // the receiver reported holding it (SACK) ahead of the ackno
+  bool lost {};                // RACK decided it was lost; retransmitted on the next push()
+
+  uint64_t end() const { return abs_seqno + msg.sequence_length(); } // one past its last seqno
+};
+
+/*
+ * The sender's outstanding segments, oldest first, in a ring of power-of-two size: the i-th
+ * outstanding segment lives at ring_[(head_ + i) & (ring_.size() - 1)]. The ring grows on demand
+ * and is never shrunk, so a connection in steady state sends and acknowledges segments without
+ * touching the allocator, and cumulative ACK processing only compares absolute seqnos and bumps
+ * `head_` (payloads are moved in once and never copied).
+ */
+class RetransmissionQueue
+{
+public:
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  OutstandingSegment& front() { return ring_[head_]; }
+  const OutstandingSegment& front() const { return ring_[head_]; }
+  OutstandingSegment& operator[]( size_t i ) { return ring_[( head_ + i ) & ( ring_.size() - 1 )]; }
+  const OutstandingSegment& operator[]( size_t i ) const { return ring_[( head_ + i ) & ( ring_.size() - 1 )]; }
+
+  void push_back( OutstandingSegment&& segment ); // Append the newest segment
+  void pop_front();                               // Forget the oldest segment (releasing its payload)
+
+  size_t lower_bound( uint64_t abs_seqno ) const; // Index of the first segment starting at or after abs_seqno
+
+private:
+  std::vector<OutstandingSegment> ring_ {};
+  size_t head_ {};
+  size_t size_ {};
+
+  void grow();
+};
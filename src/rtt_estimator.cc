@@ -0,0 +1,32 @@
+#include "rtt_estimator.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void RTTEstimator::sample( uint64_t rtt_ms )
+{
+  const double r = static_cast<double>( rtt_ms );
+
+  if ( not has_sample_ ) {
+    has_sample_ = true;
+    srtt_ms_ = r;
+    rttvar_ms_ = r / 2;
+    return;
+  }
+
+  // alpha = 1/8, beta = 1/4; RTTVAR is updated with the old SRTT
+  rttvar_ms_ = 0.75 * rttvar_ms_ + 0.25 * abs( srtt_ms_ - r );
+  srtt_ms_ = 0.875 * srtt_ms_ + 0.125 * r;
+}
+
+uint64_t RTTEstimator::rto_ms() const
+{
+  if ( not has_sample_ ) {
+    return initial_RTO_ms_;
+  }
+
+  const double rto = srtt_ms_ + max( CLOCK_GRANULARITY_MS, 4 * rttvar_ms_ );
+  return clamp( static_cast<uint64_t>( ceil( rto ) ), min_RTO_ms_, max_RTO_ms_ );
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Round-trip-time estimator and retransmission-timeout calculation from RFC 6298.
+ *
+ * Each sample (in milliseconds) updates the smoothed RTT (SRTT) and RTT variation (RTTVAR);
+ * the RTO is SRTT + max(G, 4 * RTTVAR), clamped to [min_RTO_ms, max_RTO_ms]. Until the first
+ * sample arrives the RTO is the initial value. Callers must apply Karn's algorithm: never
+ * sample a segment that was retransmitted.
+ */
+class RTTEstimator
+{
+public:
+  RTTEstimator( uint64_t initial_RTO_ms, uint64_t min_RTO_ms, uint64_t max_RTO_ms )
+    : initial_RTO_ms_( initial_RTO_ms ), min_RTO_ms_( min_RTO_ms ), max_RTO_ms_( max_RTO_ms )
+  {}
+
+  void sample( uint64_t rtt_ms ); // Fold in one round-trip measurement
+
+  bool has_sample() const { return has_sample_; }
+  double srtt_ms() const { return srtt_ms_; }
+  double rttvar_ms() const { return rttvar_ms_; }
+  uint64_t rto_ms() const; // Current RTO, before any timeout backoff
+
+  uint64_t max_RTO_ms() const { return max_RTO_ms_; }
+
+  static constexpr double CLOCK_GRANULARITY_MS = 1; // G: the sender's clock ticks in milliseconds
+
+private:
+  uint64_t initial_RTO_ms_;
+  uint64_t min_RTO_ms_;
+  uint64_t max_RTO_ms_;
+
+  bool has_sample_ {};
+  double srtt_ms_ {};
+  double rttvar_ms_ {};
+};
@@ -3,3 +3,7 @@
 //! Specializations of TCPMinnowSocket for TCPOverIPv4OverTunFdAdapter and its lossy version
 template class TCPMinnowSocket<TCPOverIPv4OverTunFdAdapter>;
 template class TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>>;
+
+//! ...and for TCPOverIPv4OverUDPFdAdapter and its lossy version
+template class TCPMinnowSocket<TCPOverIPv4OverUDPFdAdapter>;
+template class TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4OverUDPFdAdapter>>;
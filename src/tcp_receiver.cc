@@ -1,5 +1,21 @@
 #include "tcp_receiver.hh"
 
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+
+static constexpr uint8_t MAX_WINDOW_SHIFT = 14; // RFC 7323
+
+TCPReceiver::TCPReceiver( Reassembler&& reassembler, bool offer_sack )
+  : reassembler_( std::move( reassembler ) ), sack_offered_( offer_sack )
+{
+  // smallest shift that lets the full capacity be advertised
+  while ( window_shift_ < MAX_WINDOW_SHIFT and ( writer().available_capacity() >> window_shift_ ) > UINT16_MAX ) {
+    ++window_shift_;
+  }
+}
+
 void TCPReceiver::receive( TCPSenderMessage message )
 {
     if ( writer().has_error() )
@@ -22,13 +38,29 @@ void TCPReceiver::receive( TCPSenderMessage message )
         }
 
         zero_point_.emplace( message.seqno );
+        window_scaling_ = message.window_scale.has_value();
+        peer_sack_permitted_ = message.sack_permitted;
     }
 
     const uint64_t check_point = writer().bytes_pushed();
     const uint64_t abs_seq = message.seqno.unwrap(zero_point_.value(), check_point );
     const uint64_t stream_index = ( message.SYN == true ) ? 0 : abs_seq - 1;
 
-    reassembler_.insert( stream_index, message.payload, message.FIN);
+    if ( message.timestamp.has_value() ) {
+      // PAWS: a timestamp older than the last one echoed means an old duplicate whose seqno may have wrapped
+      const uint32_t tsval = message.timestamp.value();
+      if ( ts_recent_.has_value() and static_cast<int32_t>( tsval - ts_recent_.value() ) < 0 ) {
+        ++paws_rejected_;
+        return;
+      }
+
+      // only a segment that starts at or before the ackno updates the echo (RFC 7323, section 4.3)
+      if ( abs_seq <= check_point + 1 or message.SYN ) {
+        ts_recent_ = tsval;
+      }
+    }
+
+    reassembler_.insert( stream_index, std::move( message.payload ), message.FIN );
 }
 
 TCPReceiverMessage TCPReceiver::send() const
@@ -39,14 +71,49 @@ TCPReceiverMessage TCPReceiver::send() const
     }
 
     TCPReceiverMessage message;
+    message.window_size = window_size();
+    message.ackno = ackno();
 
-    message.window_size = ( writer().available_capacity() > UINT16_MAX ) ? UINT16_MAX : writer().available_capacity();
+    if ( message.ackno.has_value() ) {
+      message.timestamp_echo = ts_recent_;
 
-    if ( zero_point_.has_value() )
-    {
-        const uint64_t ack = writer().bytes_pushed() + 1 + static_cast<uint64_t> ( writer().is_closed() );
-        message.ackno = Wrap32::wrap( ack, zero_point_.value() );
+      // report what the reassembler holds beyond the ackno (stream index i is absolute seqno i + 1);
+      // an echoed timestamp leaves room for one block fewer, and the oldest would be the one cut
+      if ( sack_permitted() ) {
+        const size_t max_blocks = ts_recent_.has_value() ? TCPReceiverMessage::MAX_SACK_BLOCKS_WITH_TIMESTAMP
+                                                         : TCPReceiverMessage::MAX_SACK_BLOCKS;
+        std::array<std::pair<uint64_t, uint64_t>, TCPReceiverMessage::MAX_SACK_BLOCKS> ranges {};
+        const size_t count = reassembler_.recent_ranges( std::span { ranges }.first( max_blocks ) );
+        for ( size_t i = 0; i < count; ++i ) {
+          const auto& [first, end] = ranges[i];
+          message.sack_blocks.push_back(
+            { Wrap32::wrap( first + 1, zero_point_.value() ), Wrap32::wrap( end + 1, zero_point_.value() ) } );
+        }
+      }
     }
 
     return message;
 }
+
+std::optional<Wrap32> TCPReceiver::ackno() const
+{
+  if ( reader().has_error() or not zero_point_.has_value() ) {
+    return std::nullopt;
+  }
+  const uint64_t ack = writer().bytes_pushed() + 1 + static_cast<uint64_t>( writer().is_closed() );
+  return Wrap32::wrap( ack, zero_point_.value() );
+}
+
+uint16_t TCPReceiver::window_size() const
+{
+  if ( reader().has_error() ) {
+    return 0;
+  }
+  const uint64_t window = writer().available_capacity() >> ( window_scaling_ ? window_shift_ : 0 );
+  return std::min<uint64_t>( window, UINT16_MAX );
+}
+
+uint16_t TCPReceiver::syn_window_size() const
+{
+  return std::min<uint64_t>( writer().available_capacity(), UINT16_MAX );
+}
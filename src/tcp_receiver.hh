@@ -8,8 +8,8 @@
 class TCPReceiver
 {
 public:
-  // Construct with given Reassembler
-  explicit TCPReceiver( Reassembler&& reassembler ) : reassembler_( std::move( reassembler ) ) {}
+  // Construct with given Reassembler; `offer_sack` says whether our SYN carries SACK-permitted
+  explicit TCPReceiver( Reassembler&& reassembler, bool offer_sack = false );
 
   /*
    * The TCPReceiver receives TCPSenderMessages, inserting their payload into the Reassembler
@@ -20,6 +20,24 @@ public:
   // The TCPReceiver sends TCPReceiverMessages to the peer's TCPSender.
   TCPReceiverMessage send() const;
 
+  // The ackno and window that send() would report, without building a message (or its SACK blocks)
+  std::optional<Wrap32> ackno() const;
+  uint16_t window_size() const;
+
+  // Window scaling (RFC 7323): the shift to advertise in our SYN, chosen so the whole capacity fits
+  // in the 16-bit window field. It is applied once the peer's SYN has carried a window scale too.
+  uint8_t window_scale() const { return window_shift_; }
+  bool window_scaling() const { return window_scaling_; }
+  uint16_t syn_window_size() const; // Window for a segment that carries our SYN (never scaled)
+
+  // SACK (RFC 2018): blocks are reported only if our SYN offered SACK and the peer's SYN did too
+  bool offers_sack() const { return sack_offered_; }
+  bool sack_permitted() const { return sack_offered_ and peer_sack_permitted_; }
+
+  // Timestamps (RFC 7323): the TSval echoed back to the peer, and how many segments PAWS has discarded
+  std::optional<uint32_t> timestamp_recent() const { return ts_recent_; }
+  uint64_t paws_rejected() const { return paws_rejected_; }
+
   // Access the output (only Reader is accessible non-const)
   const Reassembler& reassembler() const { return reassembler_; }
   Reader& reader() { return reassembler_.reader(); }
@@ -29,4 +47,13 @@ public:
 private:
   Reassembler reassembler_;
   std::optional<Wrap32> zero_point_ {};
+
+  uint8_t window_shift_ {};
+  bool window_scaling_ { false };
+
+  bool sack_offered_ { false };
+  bool peer_sack_permitted_ { false };
+
+  std::optional<uint32_t> ts_recent_ {};
+  uint64_t paws_rejected_ {};
 };
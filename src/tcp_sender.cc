@@ -1,6 +1,8 @@
 #include "tcp_sender.hh"
 #include "tcp_config.hh"
 #include <algorithm>
+#include <cmath>
+#include <string_view>
 
 using namespace std;
 
@@ -9,78 +11,138 @@ uint64_t TCPSender::sequence_numbers_in_flight() const
   return outstanding_bytes_;
 }
 
+uint64_t TCPSender::bytes_in_pipe() const
+{
+  return outstanding_bytes_ - sacked_bytes_ - lost_bytes_;
+}
+
 uint64_t TCPSender::consecutive_retransmissions() const
 {
   return consecutive_retransmissions_;
 }
 
+uint64_t TCPSender::effective_cwnd() const
+{
+  const uint64_t cwnd = congestion_control_->cwnd();
+  return cwnd > UINT64_MAX - recovery_inflation_ ? UINT64_MAX : cwnd + recovery_inflation_;
+}
+
 void TCPSender::push( const TransmitFunction& transmit )
 {
+  if ( retransmit_pending_ && !outstanding_segments_.empty() ) // 快速重传
+  {
+    retransmit_front( transmit );
+  }
+  retransmit_pending_ = false;
+  pacing_blocked_ = false;
+
+  if ( lost_bytes_ > 0 ) // 认定丢失的段先于新数据重传
+  {
+    retransmit_lost( transmit );
+  }
+
   while (true)
   {
-    if (window_size_ == 0) // 发送窗口为0时置1
-    {
-      window_size_ = 1;  
+    // 接收窗口限制未ack的序列号, 拥塞窗口限制网络中的字节 (pipe)
+    const uint64_t window { send_window() };
+    const uint64_t cwnd { effective_cwnd() };
+    const uint64_t pipe { bytes_in_pipe() };
+    if ( outstanding_bytes_ >= window || pipe >= cwnd ) {
+      arm_persist();
+      return;
     }
+    const uint64_t room { std::min( window - outstanding_bytes_, cwnd - pipe ) };
 
-    if (outstanding_bytes_ > window_size_)
+    if ( pacing_rate().has_value() && pacing_tokens_ <= 0 ) // 令牌不足, 等tick()补充
     {
+      pacing_blocked_ = has_new_data();
       return;
     }
 
-    TCPSenderMessage msg { make_empty_message() };
-    if (!SYN_sent_)  // 发syn包
+    if ( hold_small_segment() ) // 等待更多数据以凑满一个段
     {
-        msg.SYN = true;
-        SYN_sent_ = true;
+      return;
     }
 
-    size_t max_payload = std::min(TCPConfig::MAX_PAYLOAD_SIZE, 
-                            window_size_ - outstanding_bytes_ - (msg.SYN ? 1 : 0));
-
-    std::string payload;
-    while (reader().bytes_buffered() != 0 && max_payload) // 缓冲区有数据且有空间
-    { 
-          std::string_view view = reader().peek();
-          view = view.substr(0, max_payload);
-          payload += view;
-          max_payload -= payload.size();
-          input_.reader().pop(view.size()); // 从缓冲区删除
+    const uint64_t sent { send_new_segment( room, transmit ) };
+    if ( sent == 0 ) {
+      return;
     }
+    pacing_tokens_ -= static_cast<double>( sent );
+  }
+}
 
-    msg.payload = payload;
+uint64_t TCPSender::send_new_segment( uint64_t room, const TransmitFunction& transmit )
+{
+  TCPSenderMessage msg { make_empty_message() };
+  if ( !SYN_sent_ ) // 发syn包
+  {
+    msg.SYN = true;
+    msg.mss = advertised_mss_;
+    SYN_sent_ = true;
+  }
 
-    if (!FIN_sent_&& (window_size_ > outstanding_bytes_ + msg.sequence_length()) && reader().is_finished() )
-    {
-        FIN_sent_ = true;
-        msg.FIN  = true;
-    }
-    
-    if (msg.sequence_length() == 0) // 没有任何信息的空段
-    {
-      return;
-    }
+  // 数据和窗口都足够时, 用一个更大的段探测路径MTU
+  uint64_t segment_size { mss_ };
+  const uint64_t probe_size { next_probe_size() };
+  const bool is_probe { probe_size > 0 && !msg.SYN && reader().bytes_buffered() >= probe_size
+                        && room >= probe_size };
+  if ( is_probe ) {
+    segment_size = probe_size;
+  }
 
-    transmit(msg);
+  const size_t max_payload = std::min<uint64_t>( segment_size, room - ( msg.SYN ? 1 : 0 ) );
 
-    if (!timer_running_) // 启动计时器
-    {
-        timer_running_ = true; 
-        timer_elapsed_ = 0;
-    }
+  msg.payload = input_.reader().pop_chunk( max_payload ); // 直接取出负载, 无需逐段拼接
+
+  if ( !FIN_sent_ && ( room > msg.sequence_length() ) && reader().is_finished() ) {
+    FIN_sent_ = true;
+    msg.FIN = true;
+  }
 
-    next_abs_seqno_ += msg.sequence_length(); 
-    outstanding_bytes_ += msg.sequence_length(); // 更新已send未ack字节数
-    outstanding_segments_.emplace(std::move(msg)); // 插入队列
+  if ( msg.sequence_length() == 0 ) // 没有任何信息的空段
+  {
+    return 0;
+  }
+
+  transmit( msg );
+
+  if ( !timer_running_ ) // 启动计时器
+  {
+    timer_running_ = true;
+    timer_elapsed_ = 0;
+  }
+
+  const uint64_t abs_seqno { next_abs_seqno_ };
+  next_abs_seqno_ += msg.sequence_length();
+  if ( is_probe ) {
+    probe_end_ = next_abs_seqno_;
+    probe_size_ = probe_size;
   }
+  const uint64_t length { msg.sequence_length() };
+  outstanding_bytes_ += length; // 更新已send未ack字节数
+  outstanding_segments_.push_back(
+    { abs_seqno, std::move( msg ), current_time_ms_ } ); // 插入环形队列, 记录发送时间
+  arm_tlp();
+  return length;
 }
 
 TCPSenderMessage TCPSender::make_empty_message() const
 {
-  return { Wrap32::wrap(next_abs_seqno_, isn_), false, {}, false, input_.has_error() };
+  TCPSenderMessage msg { Wrap32::wrap( next_abs_seqno_, isn_ ), false, {}, false, input_.has_error() };
+  msg.timestamp = timestamp_now();
+  return msg;
 }
 
-void TCPSender::receive( const TCPReceiverMessage& msg )
+optional<uint32_t> TCPSender::timestamp_now() const
+{
+  if ( !timestamps_ ) {
+    return nullopt;
+  }
+  return static_cast<uint32_t>( current_time_ms_ ); // 毫秒时钟, 按2^32回绕
+}
+
+void TCPSender::receive( const TCPReceiverMessage& msg, bool pure_ack )
 {
   if (msg.RST)
   {
@@ -88,10 +150,18 @@ void TCPSender::receive( const TCPReceiverMessage& msg )
     return;
   }
 
-  window_size_ = msg.window_size; // 更新窗口
-  if (msg.window_size == 0)
-  {
-    zero_window_ = true;
+  // 比snd_una旧的ack是乱序到达的旧段, 它的窗口也已过时
+  if ( msg.ackno.has_value()
+       && msg.ackno->unwrap( isn_, next_abs_seqno_ ) < next_abs_seqno_ - outstanding_bytes_ ) {
+    return;
+  }
+
+  const uint64_t previous_window { window_size_ };
+  window_size_ = static_cast<uint64_t>( msg.window_size ) << window_shift_; // 更新窗口
+  if ( window_size_ > 0 ) {
+    exit_persist();
+  } else {
+    arm_persist();
   }
 
   if (!msg.ackno.has_value())
@@ -105,29 +175,85 @@ void TCPSender::receive( const TCPReceiverMessage& msg )
   {
     return;
   }
-  
-  bool acked_any {false};
-  while (!outstanding_segments_.empty())
-  {
-    TCPSenderMessage seg { outstanding_segments_.front() };
 
-    if (seg.seqno.unwrap(isn_, next_abs_seqno_) + seg.sequence_length() <= abs_ackno) // 已ack, pop
-    {
-      outstanding_bytes_ -= seg.sequence_length();
-      outstanding_segments_.pop();
+  if ( abs_ackno == next_abs_seqno_ - outstanding_bytes_ ) // 没有确认新数据
+  {
+    // 携带数据的段和零窗口下回应探测的ack都不算重复ack
+    if ( pure_ack && window_size_ == previous_window && window_size_ > 0 ) {
+      receive_duplicate_ack();
+    }
+    detect_losses( msg.sack_blocks ); // 重复ack携带的SACK块也能说明哪些段已送达
+    return;
+  }
+  dup_acks_ = 0;
 
-      acked_any = true;
+  bool acked_any {false};
+  uint64_t bytes_acked {};
+  std::optional<uint64_t> rtt_sample {}; // 最后一个被ack且未重传过的段的RTT
+  while ( !outstanding_segments_.empty() && outstanding_segments_.front().end() <= abs_ackno ) // 已ack, pop
+  {
+    const OutstandingSegment& front { outstanding_segments_.front() };
+    if ( rack_tlp_ && !front.sacked ) {
+      rack_delivered( front );
     }
+    sacked_bytes_ -= front.sacked ? front.msg.sequence_length() : 0;
+    lost_bytes_ -= front.lost ? front.msg.sequence_length() : 0;
+    outstanding_bytes_ -= front.msg.sequence_length();
+    bytes_acked += front.msg.sequence_length();
+    rtt_sample = front.retransmitted ? std::nullopt : std::optional { current_time_ms_ - front.sent_ms };
+    outstanding_segments_.pop_front();
+
+    acked_any = true;
+  }
 
-    else
+  if ( acked_any && timestamps_ && msg.timestamp_echo.has_value() ) // 回显的时间戳不受重传歧义影响
+  {
+    const uint32_t echo_rtt { static_cast<uint32_t>( current_time_ms_ ) - *msg.timestamp_echo };
+    if ( echo_rtt <= INT32_MAX ) // 忽略来自"未来"的回显
     {
-      break;
+      rtt_sample = echo_rtt;
     }
   }
 
+  if ( rtt_sample.has_value() ) {
+    rtt_.sample( *rtt_sample ); // 即使RTO固定, SRTT也用于计算发送速率
+  }
+
+  if ( tlp_end_.has_value() && abs_ackno >= *tlp_end_ ) {
+    tlp_end_.reset();
+  }
+
+  detect_losses( msg.sack_blocks );
+
+  if ( probe_end_.has_value() && abs_ackno >= *probe_end_ ) // 探测段到达: 路径可以承载更大的段
+  {
+    set_mss( probe_size_ );
+    probe_end_.reset();
+    probe_failures_ = 0;
+  }
+
   if (acked_any)
   {
-    RTO_ms_ = initial_RTO_ms_;
+    if ( !in_fast_recovery_ ) {
+      congestion_control_->on_ack( bytes_acked, current_time_ms_ );
+    } else if ( abs_ackno >= recover_ ) // 完全ack: 退出快速恢复
+    {
+      in_fast_recovery_ = false;
+      recovery_inflation_ = 0;
+      ++losses_repaired_without_rto_;
+    } else if ( !rack_tlp_ && sacked_bytes_ == 0 ) // NewReno部分ack: 重传下一个空洞, 收缩膨胀的窗口
+    {                                              // (有RACK或SACK信息时由它们判断哪些段丢失)
+      retransmit_pending_ = true;
+      recovery_inflation_ = ( recovery_inflation_ > bytes_acked ? recovery_inflation_ - bytes_acked : 0 ) + mss_;
+    }
+
+    if ( !adaptive_rto_ ) {
+      RTO_ms_ = initial_RTO_ms_;
+    } else if ( rtt_sample.has_value() ) // Karn: 没有有效样本时保留退避后的RTO
+    {
+      RTO_ms_ = rtt_.rto_ms();
+    }
+
     timer_elapsed_ = 0;
     consecutive_retransmissions_ = 0;
 
@@ -136,11 +262,359 @@ void TCPSender::receive( const TCPReceiverMessage& msg )
       timer_running_ = false;
       timer_elapsed_ = 0;
     }
+    arm_tlp();
+  }
+}
+
+void TCPSender::set_peer_mss( uint64_t peer_mss )
+{
+  max_mss_ = std::min( max_mss_, std::max<uint64_t>( peer_mss, 1 ) );
+  probe_search_high_ = std::min( probe_search_high_, max_mss_ );
+  set_mss( std::min( mss_, max_mss_ ) );
+}
+
+void TCPSender::set_mss( uint64_t mss )
+{
+  mss_ = mss;
+  congestion_control_->set_mss( mss );
+}
+
+uint64_t TCPSender::next_probe_size() const
+{
+  if ( !pmtu_probing_ || probe_end_.has_value() || probe_search_high_ < mss_ + PMTU_PROBE_MIN_STEP ) {
+    return 0;
+  }
+  return ( mss_ + probe_search_high_ + 1 ) / 2; // 二分搜索
+}
+
+void TCPSender::retransmit( size_t index, const TransmitFunction& transmit )
+{
+  OutstandingSegment& front { outstanding_segments_[index] };
+  front.retransmitted = true;
+  front.sent_ms = current_time_ms_;
+  front.msg.timestamp = timestamp_now(); // 重传段带上新的时间戳
+  if ( front.lost ) {
+    front.lost = false;
+    lost_bytes_ -= front.msg.sequence_length();
+  }
+
+  if ( probe_end_.has_value() && front.end() == *probe_end_ ) // 探测段丢失
+  {
+    probe_end_.reset();
+    if ( ++probe_failures_ >= PMTU_MAX_PROBES ) // 连续丢失多次才认定这个大小过大
+    {
+      probe_search_high_ = probe_size_ - 1;
+      probe_failures_ = 0;
+      probe_raise_ms_ = current_time_ms_ + PMTU_RAISE_INTERVAL_MS;
+    }
+  }
+
+  bytes_retransmitted_ += front.msg.payload.size();
+  if ( front.msg.payload.size() <= mss_ ) {
+    transmit( front.msg );
+    ++segments_retransmitted_;
+    return;
+  }
+
+  // 段比当前MSS大 (失败的探测段): 拆成MSS大小的段重传
+  const string_view payload { front.msg.payload };
+  for ( uint64_t offset = 0; offset < payload.size(); offset += mss_ ) {
+    TCPSenderMessage piece {};
+    piece.seqno = Wrap32::wrap( front.abs_seqno + front.msg.SYN + offset, isn_ );
+    piece.SYN = front.msg.SYN && offset == 0;
+    piece.payload = string( payload.substr( offset, mss_ ) );
+    piece.FIN = front.msg.FIN && offset + mss_ >= payload.size();
+    piece.RST = front.msg.RST;
+    piece.timestamp = front.msg.timestamp;
+    transmit( piece );
+    ++segments_retransmitted_;
+  }
+}
+
+void TCPSender::rack_delivered( const OutstandingSegment& segment )
+{
+  const uint64_t rtt { current_time_ms_ - segment.sent_ms };
+  if ( segment.retransmitted && rack_min_rtt_ms_.has_value() && rtt < *rack_min_rtt_ms_ ) {
+    return; // 太快了, 这个ack多半是给原始发送的
+  }
+  if ( !segment.retransmitted ) {
+    rack_min_rtt_ms_ = std::min( rack_min_rtt_ms_.value_or( rtt ), rtt );
+  }
+
+  if ( segment.sent_ms > rack_xmit_ms_ || ( segment.sent_ms == rack_xmit_ms_ && segment.end() > rack_end_ ) ) {
+    rack_xmit_ms_ = segment.sent_ms;
+    rack_end_ = segment.end();
+    rack_rtt_ms_ = rtt;
+  }
+}
+
+void TCPSender::detect_losses( const SACKBlockList& blocks )
+{
+  if ( !rack_tlp_ && !sack_recovery_ ) {
+    return;
+  }
+  update_scoreboard( blocks );
+  if ( rack_tlp_ ) {
+    rack_detect_loss();
+  }
+  if ( sack_recovery_ ) {
+    sack_detect_loss();
+  }
+}
+
+void TCPSender::update_scoreboard( const SACKBlockList& blocks )
+{
+  for ( const SACKBlock& block : blocks ) {
+    const uint64_t left { block.left.unwrap( isn_, next_abs_seqno_ ) };
+    const uint64_t right { block.right.unwrap( isn_, next_abs_seqno_ ) };
+    // 段按序列号排列: 二分找到块里的第一个段, 走到块的右边界为止
+    for ( size_t i = outstanding_segments_.lower_bound( left ); i < outstanding_segments_.size(); ++i ) {
+      OutstandingSegment& segment { outstanding_segments_[i] };
+      if ( segment.end() > right ) {
+        break;
+      }
+      if ( segment.sacked ) {
+        continue;
+      }
+      segment.sacked = true;
+      sacked_bytes_ += segment.msg.sequence_length();
+      highest_sacked_ = std::max( highest_sacked_, segment.end() );
+      if ( segment.lost ) {
+        segment.lost = false;
+        lost_bytes_ -= segment.msg.sequence_length();
+      }
+      if ( rack_tlp_ ) {
+        rack_delivered( segment );
+      }
+    }
+  }
+}
+
+void TCPSender::sack_detect_loss()
+{
+  if ( sacked_bytes_ == 0 ) {
+    return;
+  }
+
+  // RFC 6675 IsLost: 之上有SACK_DUP_THRESH个被SACK的段, 或超过(SACK_DUP_THRESH-1)*MSS字节被SACK
+  bool any_lost { false };
+  uint64_t sacked_segments_above {};
+  uint64_t sacked_bytes_above {};
+  for ( size_t i = outstanding_segments_.lower_bound( highest_sacked_ ); i-- > 0; ) // 最高的SACK段之上没有丢失
+  {
+    OutstandingSegment& segment { outstanding_segments_[i] };
+    if ( segment.sacked ) {
+      ++sacked_segments_above;
+      sacked_bytes_above += segment.msg.sequence_length();
+      continue;
+    }
+    if ( segment.lost || segment.retransmitted ) // 重传过的段再丢失由RACK或RTO处理
+    {
+      continue;
+    }
+    if ( sacked_segments_above >= SACK_DUP_THRESH || sacked_bytes_above > ( SACK_DUP_THRESH - 1 ) * mss_ ) {
+      mark_lost( segment );
+      any_lost = true;
+    }
+  }
+
+  if ( any_lost ) {
+    enter_recovery();
+  }
+}
+
+void TCPSender::mark_lost( OutstandingSegment& segment )
+{
+  segment.lost = true;
+  lost_bytes_ += segment.msg.sequence_length();
+}
+
+void TCPSender::enter_recovery()
+{
+  if ( in_fast_recovery_ ) // 每个恢复周期只降一次窗口
+  {
+    return;
+  }
+  congestion_control_->on_loss( outstanding_bytes_, current_time_ms_ );
+  in_fast_recovery_ = true;
+  recover_ = next_abs_seqno_;
+  recovery_inflation_ = 0;
+  tlp_timer_ms_.reset();
+}
+
+void TCPSender::rack_detect_loss()
+{
+  rack_timer_ms_.reset();
+  if ( rack_end_ == 0 ) // 还没有段被确认过
+  {
+    return;
+  }
+
+  const uint64_t reo_wnd { rack_min_rtt_ms_.value_or( 0 ) / 4 }; // 容忍的重排序时间
+  bool any_lost { false };
+  for ( size_t i = 0; i < outstanding_segments_.size(); ++i ) {
+    OutstandingSegment& segment { outstanding_segments_[i] };
+    const bool sent_before_delivered { segment.sent_ms < rack_xmit_ms_
+                                       || ( segment.sent_ms == rack_xmit_ms_ && segment.end() < rack_end_ ) };
+    if ( !segment.retransmitted && !sent_before_delivered ) {
+      break; // 新数据按序列号顺序发送, 之后的段 (包括重传过的) 都发得更晚
+    }
+    if ( segment.sacked || segment.lost || !sent_before_delivered ) {
+      continue;
+    }
+
+    const uint64_t deadline { segment.sent_ms + rack_rtt_ms_ + reo_wnd };
+    if ( deadline <= current_time_ms_ ) {
+      mark_lost( segment );
+      any_lost = true;
+    } else // 重排序窗口还没过去, 到时再检查
+    {
+      rack_timer_ms_ = std::max( rack_timer_ms_.value_or( 0 ), deadline );
+    }
+  }
+
+  if ( any_lost ) {
+    enter_recovery();
+  }
+}
+
+void TCPSender::retransmit_lost( const TransmitFunction& transmit )
+{
+  const uint64_t cwnd { effective_cwnd() };
+  for ( size_t i = 0; i < outstanding_segments_.size() && lost_bytes_ > 0 && bytes_in_pipe() < cwnd; ++i ) {
+    if ( outstanding_segments_[i].lost ) {
+      retransmit( i, transmit );
+      ++loss_retransmits_;
+    }
+  }
+}
+
+void TCPSender::arm_tlp()
+{
+  tlp_timer_ms_.reset();
+  if ( !rack_tlp_ || outstanding_segments_.empty() || in_fast_recovery_ || tlp_end_.has_value() ) {
+    return;
+  }
+
+  // PTO = 2*SRTT (没有样本时用初始RTO), 不晚于RTO
+  uint64_t pto { rtt_.has_sample() ? static_cast<uint64_t>( ceil( 2 * rtt_.srtt_ms() ) ) : initial_RTO_ms_ };
+  if ( outstanding_segments_.size() == 1 ) {
+    pto += TLP_MAX_ACK_DELAY_MS;
+  }
+  pto = std::min( pto, RTO_ms_ > timer_elapsed_ ? RTO_ms_ - timer_elapsed_ : 0 );
+  tlp_timer_ms_ = current_time_ms_ + pto;
+}
+
+void TCPSender::receive_duplicate_ack()
+{
+  if ( dup_ack_threshold_ == 0 || outstanding_segments_.empty() ) {
+    return;
+  }
+
+  ++dup_acks_;
+
+  if ( in_fast_recovery_ ) // 每个重复ack代表一个段离开了网络, 膨胀窗口以保持管道满
+  {
+    recovery_inflation_ += mss_;
+    return;
+  }
+
+  if ( dup_acks_ == dup_ack_threshold_ ) // 快速重传, 进入快速恢复
+  {
+    congestion_control_->on_loss( outstanding_bytes_, current_time_ms_ );
+    in_fast_recovery_ = true;
+    recover_ = next_abs_seqno_;
+    recovery_inflation_ = dup_ack_threshold_ * mss_;
+    retransmit_pending_ = true;
+    ++fast_retransmits_;
+  }
+}
+
+optional<double> TCPSender::pacing_rate() const
+{
+  if ( !pacing_ ) {
+    return nullopt;
+  }
+
+  optional<double> rate {};
+  const uint64_t cwnd { effective_cwnd() };
+  if ( rtt_.has_sample() && cwnd != UINT64_MAX ) // cwnd/SRTT, 慢启动时加倍
+  {
+    const double gain { cwnd < congestion_control_->ssthresh() ? PACING_GAIN_SLOW_START : PACING_GAIN_AVOIDANCE };
+    rate = gain * static_cast<double>( cwnd ) / max( rtt_.srtt_ms(), 1.0 );
   }
+  if ( pacing_rate_cap_ > 0 ) {
+    const double cap { static_cast<double>( pacing_rate_cap_ ) / 1000 };
+    rate = rate.has_value() ? min( *rate, cap ) : cap;
+  }
+  return rate;
+}
+
+bool TCPSender::has_new_data() const
+{
+  return !SYN_sent_ || reader().bytes_buffered() > 0 || ( reader().is_finished() && !FIN_sent_ );
+}
+
+bool TCPSender::hold_small_segment() const
+{
+  const uint64_t buffered { reader().bytes_buffered() };
+  if ( !SYN_sent_ || writer().is_closed() || buffered == 0 || buffered >= mss_ ) {
+    return false;
+  }
+
+  if ( reader().bytes_popped() < flush_up_to_ ) // flush()过的数据立即发送
+  {
+    return false;
+  }
+
+  return corked_ || ( nagle_ && outstanding_bytes_ > 0 );
+}
+
+optional<uint64_t> TCPSender::ms_until_next_send() const
+{
+  const optional<double> rate { pacing_rate() };
+  if ( !pacing_blocked_ || !rate.has_value() ) {
+    return nullopt;
+  }
+  return static_cast<uint64_t>( -pacing_tokens_ / *rate ) + 1;
 }
 
 void TCPSender::tick( uint64_t ms_since_last_tick, const TransmitFunction& transmit )
 {
+  current_time_ms_ += ms_since_last_tick;
+
+  if ( const optional<double> rate { pacing_rate() }; rate.has_value() ) // 补充令牌, 释放被节流的段
+  {
+    const double burst { PACING_BURST_SEGMENTS * static_cast<double>( mss_ ) };
+    pacing_tokens_ = min( burst, pacing_tokens_ + *rate * static_cast<double>( ms_since_last_tick ) );
+    if ( pacing_blocked_ && pacing_tokens_ > 0 ) {
+      push( transmit );
+    }
+  }
+
+  if ( probe_raise_ms_.has_value() && current_time_ms_ >= *probe_raise_ms_ ) // 重新搜索路径MTU (路径可能变了)
+  {
+    probe_raise_ms_.reset();
+    probe_search_high_ = max_mss_;
+  }
+
+  if ( persist_timer_ms_.has_value() ) // 零窗口: 只有persist计时器在走
+  {
+    if ( current_time_ms_ >= *persist_timer_ms_ ) {
+      persist_timer_ms_.reset();
+      ++persist_backoff_;
+      send_window_probe( transmit );
+      arm_persist();
+    }
+    return;
+  }
+
+  if ( rack_timer_ms_.has_value() && current_time_ms_ >= *rack_timer_ms_ ) // 重排序窗口到期
+  {
+    rack_detect_loss();
+    retransmit_lost( transmit );
+  }
+
   if (!timer_running_)
   {
     return;
@@ -148,6 +622,22 @@ void TCPSender::tick( uint64_t ms_since_last_tick, const TransmitFunction& trans
 
   timer_elapsed_ += ms_since_last_tick;
 
+  if ( tlp_timer_ms_.has_value() && current_time_ms_ >= *tlp_timer_ms_ && timer_elapsed_ < RTO_ms_
+       && !outstanding_segments_.empty() ) {
+    // 尾部探测 (RFC 8985 7.3): 接收窗口允许时发一个新段, 否则重传最后一个段,
+    // 让对端的ack (和SACK) 暴露尾部的丢失
+    const uint64_t window { send_window() };
+    if ( !has_new_data() || outstanding_bytes_ >= window
+         || send_new_segment( std::min( window - outstanding_bytes_, mss_ ), transmit ) == 0 ) {
+      retransmit( outstanding_segments_.size() - 1, transmit );
+    }
+    tlp_timer_ms_.reset(); // send_new_segment()会重新设置; 探测在途时不再探测
+    tlp_end_ = outstanding_segments_[outstanding_segments_.size() - 1].end();
+    ++tail_loss_probes_;
+    timer_elapsed_ = 0;
+    return;
+  }
+
   if (timer_elapsed_ >= RTO_ms_) // 超时
   {
     if (outstanding_segments_.empty())  
@@ -155,14 +645,86 @@ void TCPSender::tick( uint64_t ms_since_last_tick, const TransmitFunction& trans
       return;
     }
 
-    transmit(outstanding_segments_.front());  // 重传
+    ++timeouts_;
+    tlp_timer_ms_.reset();
+    tlp_end_.reset();
+
+    if ( window_size_ == 0 ) // 零窗口探测 (窗口当作1) 的超时不退避
+    {
+      retransmit_front( transmit );
+      timer_elapsed_ = 0;
+      return;
+    }
+
+    congestion_control_->on_rto( outstanding_bytes_, current_time_ms_ );
+    in_fast_recovery_ = false; // 超时结束快速恢复
+    recovery_inflation_ = 0;
+    dup_acks_ = 0;
+    ++consecutive_retransmissions_;
+    RTO_ms_ *= 2;
+    if ( adaptive_rto_ ) {
+      RTO_ms_ = std::min( RTO_ms_, rtt_.max_RTO_ms() );
+    }
 
-    if (!zero_window_)
+    if ( sack_recovery_ ) // RFC 6675 5.1: 没被SACK的段都算丢失, 之后在cwnd允许时依次重传
     {
-      ++consecutive_retransmissions_;
-      RTO_ms_ *= 2;
+      for ( size_t i = 0; i < outstanding_segments_.size(); ++i ) {
+        OutstandingSegment& segment { outstanding_segments_[i] };
+        if ( !segment.sacked && !segment.lost ) {
+          mark_lost( segment );
+        }
+      }
     }
+    retransmit_front( transmit ); // 重传
+    retransmit_lost( transmit );
 
     timer_elapsed_ = 0; // 重置计时器
   }
 }
+
+uint64_t TCPSender::send_window() const
+{
+  if ( window_size_ > 0 ) {
+    return window_size_;
+  }
+  return persist_ ? 0 : 1; // 零窗口当作1, 或者只由send_window_probe()发送
+}
+
+void TCPSender::arm_persist()
+{
+  if ( !persist_ || window_size_ > 0 || persist_timer_ms_.has_value()
+       || ( outstanding_segments_.empty() && !has_new_data() ) ) {
+    return;
+  }
+
+  // 间隔从RTO开始, 每次探测加倍, 不超过RTO上限
+  uint64_t interval { RTO_ms_ };
+  for ( uint64_t i = 0; i < persist_backoff_ && interval < rtt_.max_RTO_ms(); ++i ) {
+    interval *= 2;
+  }
+  persist_timer_ms_ = current_time_ms_ + std::min( interval, std::max( rtt_.max_RTO_ms(), RTO_ms_ ) );
+}
+
+void TCPSender::exit_persist()
+{
+  if ( !persist_timer_ms_.has_value() && persist_backoff_ == 0 ) {
+    return;
+  }
+  persist_timer_ms_.reset();
+  persist_backoff_ = 0;
+  timer_elapsed_ = 0; // 在途的探测交还给RTO
+  arm_tlp();
+}
+
+void TCPSender::send_window_probe( const TransmitFunction& transmit )
+{
+  if ( !outstanding_segments_.empty() ) // 未ack的数据本身就是探测
+  {
+    retransmit_front( transmit );
+    ++window_probes_;
+    return;
+  }
+
+  // 直接发一个序列号: 不经过push(), Nagle/cork和pacing就不会扣下探测
+  window_probes_ += send_new_segment( 1, transmit ) > 0;
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "byte_stream.hh"
+#include "congestion_control.hh"
+#include "retransmission_queue.hh"
+#include "rtt_estimator.hh"
+#include "tcp_config.hh"
 #include "tcp_receiver_message.hh"
 #include "tcp_sender_message.hh"
 
@@ -10,20 +14,57 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <vector>
 
 class TCPSender
 {
 public:
   /* Construct TCP sender with given default Retransmission Timeout and possible ISN */
-  TCPSender( ByteStream&& input, Wrap32 isn, uint64_t initial_RTO_ms )
-    : input_( std::move( input ) ), isn_( isn ), initial_RTO_ms_( initial_RTO_ms ), RTO_ms_( initial_RTO_ms )
+  TCPSender( ByteStream&& input,
+             Wrap32 isn,
+             uint64_t initial_RTO_ms,
+             CongestionControlAlgorithm congestion_control = CongestionControlAlgorithm::None )
+    : input_( std::move( input ) )
+    , isn_( isn )
+    , initial_RTO_ms_( initial_RTO_ms )
+    , advertised_mss_( TCPConfig::MAX_PAYLOAD_SIZE )
+    , max_mss_( TCPConfig::MAX_PAYLOAD_SIZE )
+    , mss_( TCPConfig::MAX_PAYLOAD_SIZE )
+    , RTO_ms_( initial_RTO_ms )
+    , congestion_control_( make_congestion_control( congestion_control, mss_ ) )
+    , rtt_( initial_RTO_ms, initial_RTO_ms, initial_RTO_ms )
+  {}
+
+  /* Construct TCP sender with the ISN, timeouts and congestion control from `config` */
+  TCPSender( ByteStream&& input, const TCPConfig& config )
+    : input_( std::move( input ) )
+    , isn_( config.isn )
+    , initial_RTO_ms_( config.rt_timeout )
+    , advertised_mss_( config.mss )
+    , max_mss_( config.mss )
+    , mss_( config.pmtu_probing ? std::min<uint64_t>( config.mss, TCPConfig::MAX_PAYLOAD_SIZE ) : config.mss )
+    , RTO_ms_( config.rt_timeout )
+    , congestion_control_( make_congestion_control( config.congestion_control, mss_ ) )
+    , adaptive_rto_( config.adaptive_rto )
+    , rtt_( config.rt_timeout, config.min_rto_ms, config.max_rto_ms )
+    , dup_ack_threshold_( config.dup_ack_threshold )
+    , pacing_( config.pacing )
+    , pacing_rate_cap_( config.pacing_rate_cap )
+    , nagle_( config.nagle )
+    , pmtu_probing_( config.pmtu_probing )
+    , probe_search_high_( config.mss )
+    , timestamps_( config.timestamps )
+    , rack_tlp_( config.rack_tlp )
+    , sack_recovery_( config.sack_recovery )
+    , persist_( config.persist_timer )
   {}
 
   /* Generate an empty TCPSenderMessage */
   TCPSenderMessage make_empty_message() const;
 
-  /* Receive and process a TCPReceiverMessage from the peer's receiver */
-  void receive( const TCPReceiverMessage& msg );
+  /* Receive and process a TCPReceiverMessage from the peer's receiver. `pure_ack` says whether the
+     segment carrying it had no payload, SYN or FIN: only such an ACK can be a duplicate ACK (RFC 5681). */
+  void receive( const TCPReceiverMessage& msg, bool pure_ack = true );
 
   /* Type of the `transmit` function that the push and tick methods can use to send messages */
   using TransmitFunction = std::function<void( const TCPSenderMessage& )>;
@@ -34,9 +75,46 @@ public:
   /* Time has passed by the given # of milliseconds since the last time the tick() method was called */
   void tick( uint64_t ms_since_last_tick, const TransmitFunction& transmit );
 
+  /* When pacing holds back segments: how many ms until tick() can release the next one */
+  std::optional<uint64_t> ms_until_next_send() const;
+
+  /* Coalescing: while corked (or, with Nagle, while data is in flight) push() holds back segments
+     smaller than MAX_PAYLOAD_SIZE. flush() lets everything written so far go out on the next push(). */
+  void cork() { corked_ = true; }
+  void uncork() { corked_ = false; }
+  void flush() { flush_up_to_ = writer().bytes_pushed(); }
+  bool corked() const { return corked_; }
+
+  /* Limit segments to the MSS the peer advertised in its SYN */
+  void set_peer_mss( uint64_t peer_mss );
+
+  /* Both SYNs carried a window scale: shift the peer's advertised windows left by `shift` from now on */
+  void set_peer_window_scale( uint8_t shift ) { window_shift_ = shift; }
+
+  /* Timestamps stay on only if the peer's SYN carried the timestamp option as well */
+  void set_peer_timestamps( bool peer_sent_timestamps ) { timestamps_ = timestamps_ && peer_sent_timestamps; }
+
   // Accessors
   uint64_t sequence_numbers_in_flight() const;  // How many sequence numbers are outstanding?
+  uint64_t bytes_in_pipe() const; // Outstanding, minus what was SACKed or judged lost (what cwnd limits)
   uint64_t consecutive_retransmissions() const; // How many consecutive *re*transmissions have happened?
+  uint64_t congestion_window() const { return congestion_control_->cwnd(); }        // cwnd, in seqnos
+  uint64_t slow_start_threshold() const { return congestion_control_->ssthresh(); } // ssthresh, in seqnos
+  uint64_t current_RTO_ms() const { return RTO_ms_; }                               // RTO, including backoff
+  const RTTEstimator& rtt_estimator() const { return rtt_; }
+  uint64_t fast_retransmits() const { return fast_retransmits_; } // Losses repaired by dup-ACK retransmission
+  uint64_t losses_repaired_without_rto() const { return losses_repaired_without_rto_; } // Recoveries finished
+  bool in_fast_recovery() const { return in_fast_recovery_; }
+  uint64_t loss_retransmits() const { return loss_retransmits_; } // Segments marked lost (RACK/SACK) and resent
+  uint64_t tail_loss_probes() const { return tail_loss_probes_; } // Probes sent when the ACK clock stopped
+  uint64_t timeouts() const { return timeouts_; }                 // Times the retransmission timer fired
+  uint64_t segments_retransmitted() const { return segments_retransmitted_; } // Retransmissions, any cause
+  uint64_t bytes_retransmitted() const { return bytes_retransmitted_; }
+  uint64_t window_probes() const { return window_probes_; }         // Probes sent by the persist timer
+  bool persisting() const { return persist_timer_ms_.has_value(); } // Waiting out a zero window?
+  uint64_t mss() const { return mss_; }         // Largest payload sent right now (grows as PMTU probes succeed)
+  uint64_t max_mss() const { return max_mss_; } // Largest payload this connection may ever send
+  bool timestamps() const { return timestamps_; }
   Writer& writer() { return input_.writer(); }
   const Writer& writer() const { return input_.writer(); }
 
@@ -48,6 +126,9 @@ private:
   ByteStream input_;
   Wrap32 isn_;
   uint64_t initial_RTO_ms_;
+  uint16_t advertised_mss_; // 在SYN中通告给对端
+  uint64_t max_mss_;        // min(配置的MSS, 对端通告的MSS)
+  uint64_t mss_;            // 当前使用的MSS
 
   //
   bool timer_running_ {false};
@@ -57,12 +138,134 @@ private:
 
   uint64_t outstanding_bytes_ {}; // 未ack字节
   uint64_t consecutive_retransmissions_ {}; // 重传次数
-  std::queue<TCPSenderMessage> outstanding_segments_ {}; 
+  uint64_t timeouts_ {};                    // 超时总次数
+  uint64_t segments_retransmitted_ {};      // 重传的段数 (任何原因)
+  uint64_t bytes_retransmitted_ {};         // 重传的负载字节数
+  RetransmissionQueue outstanding_segments_ {}; // 按序列号排列的未ack段
 
-  uint16_t window_size_ {1};
+  uint64_t window_size_ { 1 }; // 对端接收窗口 (已按window_shift_放大)
+  uint8_t window_shift_ {};
   uint64_t next_abs_seqno_ {}; // 下一序列号
 
   bool SYN_sent_ {false};
   bool FIN_sent_{false};
-  bool zero_window_ {false};
+
+  // Congestion control: at most min(window_size_, cwnd) sequence numbers are in flight
+  std::unique_ptr<CongestionControl> congestion_control_;
+  uint64_t current_time_ms_ {}; // 所有tick累计的时间
+
+  // RFC 6298: when adaptive_rto_ is set, the RTO comes from measured RTTs instead of initial_RTO_ms_
+  bool adaptive_rto_ { false };
+  RTTEstimator rtt_;
+
+  // Fast retransmit and NewReno fast recovery (RFC 5681, RFC 6582)
+  uint64_t dup_ack_threshold_ {}; // 0 表示关闭
+  uint64_t dup_acks_ {};
+  bool in_fast_recovery_ { false };
+  uint64_t recover_ {};               // 进入快速恢复时已发送的最高序列号
+  uint64_t recovery_inflation_ {};    // 快速恢复期间加在cwnd上的字节数
+  bool retransmit_pending_ { false }; // 下一次push()时重传最早的未ack段
+  uint64_t fast_retransmits_ {};
+  uint64_t losses_repaired_without_rto_ {};
+
+  uint64_t effective_cwnd() const; // cwnd加上快速恢复的膨胀
+  void receive_duplicate_ack();
+
+  // Pacing: a token bucket (in seqnos) refilled by tick() at pacing_rate(), drained by each new segment
+  bool pacing_ { false };
+  uint64_t pacing_rate_cap_ {}; // 字节/秒, 0 表示无上限
+  double pacing_tokens_ { PACING_BURST_SEGMENTS * static_cast<double>( mss_ ) };
+  bool pacing_blocked_ { false }; // 上一次push()是否因令牌不足而停下
+
+  static constexpr double PACING_BURST_SEGMENTS = 2; // 桶容量, 以MSS计
+  static constexpr double PACING_GAIN_SLOW_START = 2.0;
+  static constexpr double PACING_GAIN_AVOIDANCE = 1.2;
+
+  std::optional<double> pacing_rate() const; // 字节/毫秒; 无法确定速率时不限速
+  bool has_new_data() const;                 // 是否还有未发送的SYN/数据/FIN
+  uint64_t send_new_segment( uint64_t room, const TransmitFunction& transmit ); // 发送至多room个序列号的新段,
+                                                                                // 返回序列号数 (0: 没有可发的)
+
+  // Nagle / cork: hold back small segments so small writes coalesce
+  bool nagle_ { false };
+  bool corked_ { false };
+  uint64_t flush_up_to_ {}; // 这个流下标之前的数据不再等待合并
+
+  bool hold_small_segment() const;
+
+  // Packetization-layer PMTU discovery (RFC 4821): occasionally send one segment between mss_ and
+  // probe_search_high_; if it is acknowledged the path carries it. A size counts as too big only after
+  // PMTU_MAX_PROBES lost probes in a row, and the search starts over PMTU_RAISE_INTERVAL_MS later.
+  bool pmtu_probing_ { false };
+  uint64_t probe_search_high_ {};        // 还没被证明过大的最大段长
+  std::optional<uint64_t> probe_end_ {}; // 在途探测段的结束序列号
+  uint64_t probe_size_ {};
+  uint64_t probe_failures_ {};                // 这个大小连续丢失的探测数
+  std::optional<uint64_t> probe_raise_ms_ {}; // 到时把probe_search_high_恢复为max_mss_
+
+  static constexpr uint64_t PMTU_PROBE_MIN_STEP = 32;        // 搜索区间小于这个值时停止探测
+  static constexpr uint64_t PMTU_MAX_PROBES = 3;             // RFC 4821 MAX_PROBES
+  static constexpr uint64_t PMTU_RAISE_INTERVAL_MS = 600000; // RFC 4821 建议10分钟后重新搜索
+
+  void set_mss( uint64_t mss );
+  uint64_t next_probe_size() const; // 0 表示现在不探测
+  void retransmit_front( const TransmitFunction& transmit ) { retransmit( 0, transmit ); }
+  void retransmit( size_t index, const TransmitFunction& transmit ); // 重传第index个未ack段, 必要时按MSS拆分
+
+  // Timestamps (RFC 7323): every segment carries TSval = current_time_ms_, and the echo in each ACK gives
+  // an RTT sample, even for segments that were retransmitted
+  bool timestamps_ { false };
+
+  std::optional<uint32_t> timestamp_now() const; // 未启用时为空
+
+  // RACK-TLP (RFC 8985): a segment is lost once a segment sent after it has been delivered and a
+  // reordering window has passed since; if the ACKs stop, a tail loss probe resends the last segment
+  // after about two RTTs instead of waiting for the RTO
+  bool rack_tlp_ { false };
+  uint64_t rack_xmit_ms_ {}; // 最近一次被确认的段的发送时间
+  uint64_t rack_end_ {};     // 以及它的结束序列号 (发送时间相同时比较)
+  uint64_t rack_rtt_ms_ {};  // 以及它的RTT
+  std::optional<uint64_t> rack_min_rtt_ms_ {};
+  std::optional<uint64_t> rack_timer_ms_ {}; // 重排序窗口到期的时刻
+  std::optional<uint64_t> tlp_timer_ms_ {};  // 尾部探测的时刻
+  std::optional<uint64_t> tlp_end_ {};       // 在途探测段的结束序列号
+  uint64_t tail_loss_probes_ {};
+
+  static constexpr uint64_t TLP_MAX_ACK_DELAY_MS = 200; // 只有一个段在途时, 对端可能推迟ACK
+
+  void rack_delivered( const OutstandingSegment& segment ); // 段被累计确认或SACK
+  void rack_detect_loss();
+  void arm_tlp();
+
+  // SACK scoreboard (RFC 6675): outstanding segments the peer has SACKed, or that were judged lost and
+  // not yet resent, are not in the network. The congestion window limits the rest (the "pipe"), and
+  // every lost segment is resent, lowest first, while the pipe has room.
+  bool sack_recovery_ { false };
+  uint64_t sacked_bytes_ {};   // 被SACK的未ack字节
+  uint64_t highest_sacked_ {}; // 被SACK的最高段的结束序列号
+  uint64_t lost_bytes_ {};     // 已标记丢失、尚未重传的字节
+  uint64_t loss_retransmits_ {};
+
+  static constexpr uint64_t SACK_DUP_THRESH = 3; // 之上有这么多个被SACK的段时, 空洞算作丢失
+
+  void detect_losses( const SACKBlockList& blocks ); // 更新记分板, 运行RACK和RFC 6675的丢失判断
+  void update_scoreboard( const SACKBlockList& blocks );
+  void sack_detect_loss();
+  void mark_lost( OutstandingSegment& segment );
+  void enter_recovery();
+  void retransmit_lost( const TransmitFunction& transmit );
+
+  // Persist timer (RFC 9293 3.8.6.1): while the peer's window is zero neither new data nor the RTO
+  // moves; a one-seqno window probe goes out each time the persist timer expires, and the interval
+  // doubles (up to the RTO ceiling) until an ACK reopens the window. Without it, a zero window is
+  // treated as one seqno and the RTO resends that byte without backing off.
+  bool persist_ { false };
+  std::optional<uint64_t> persist_timer_ms_ {}; // 下一次窗口探测的时刻
+  uint64_t persist_backoff_ {};                 // 本次零窗口期间已发送的探测数
+  uint64_t window_probes_ {};
+
+  uint64_t send_window() const; // push()可用的接收窗口
+  void arm_persist();
+  void exit_persist();
+  void send_window_probe( const TransmitFunction& transmit );
 };
@@ -0,0 +1,74 @@
+#include "random.hh"
+#include "socket.hh"
+#include "tcp_config.hh"
+#include "tcp_peer.hh"
+#include "tuntap_adapter.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    // two ends of a tunnel over loopback UDP
+    UDPSocket socket_a;
+    UDPSocket socket_b;
+    socket_a.bind( Address { "127.0.0.1", 0 } );
+    socket_b.bind( Address { "127.0.0.1", 0 } );
+    socket_a.connect( socket_b.local_address() );
+    socket_b.connect( socket_a.local_address() );
+
+    TCPOverIPv4OverUDPFdAdapter a { std::move( socket_a ) };
+    TCPOverIPv4OverUDPFdAdapter b { std::move( socket_b ) };
+    a.config_mut().source = Address { "10.144.0.1", 3000 };
+    a.config_mut().destination = Address { "10.144.0.2", 4000 };
+    b.config_mut().source = a.config().destination;
+    b.config_mut().destination = a.config().source;
+
+    TCPConfig cfg;
+    cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+    const Wrap32 server_isn { static_cast<uint32_t>( rd() ) };
+
+    TCPPeer peer { cfg };
+    const TCPPeer::BatchTransmitFunction transmit = [&]( span<const TCPMessage> batch ) { a.write( batch ); };
+
+    peer.outbound_writer().push( string( 10000, 'x' ) );
+    peer.push( transmit );
+    if ( a.fd().write_count() != 1 ) {
+      throw runtime_error( "expected one write for the SYN" );
+    }
+    const auto syn = b.read();
+    if ( not syn.has_value() or not syn->sender.SYN ) {
+      throw runtime_error( "the SYN did not come through the tunnel" );
+    }
+
+    // the SYN/ACK opens the window: ten segments, one system call
+    peer.receive( TCPMessage { { server_isn, true }, { cfg.isn + 1, 64000 } }, transmit );
+    if ( a.fd().write_count() != 2 ) {
+      throw runtime_error( "expected one write for the burst, got " + to_string( a.fd().write_count() - 1 ) );
+    }
+    uint32_t offset = 1;
+    for ( int i = 0; i < 10; ++i ) {
+      const auto msg = b.read();
+      if ( not msg.has_value() or msg->sender.seqno != cfg.isn + offset or msg->sender.payload.size() != 1000 ) {
+        throw runtime_error( "segment " + to_string( i ) + " of the burst did not come through intact" );
+      }
+      offset += 1000;
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
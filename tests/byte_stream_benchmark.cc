@@ -0,0 +1,290 @@
+#include "byte_stream.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// Count every heap allocation made by this process, so each operation can report allocations per call.
+static size_t allocation_count = 0; // NOLINT(*-avoid-non-const-global-variables)
+
+void* operator new( size_t size )
+{
+  ++allocation_count;
+  if ( void* ptr = malloc( size ) ) { // NOLINT(*-no-malloc)
+    return ptr;
+  }
+  throw bad_alloc {};
+}
+
+void operator delete( void* ptr ) noexcept
+{
+  free( ptr ); // NOLINT(*-no-malloc)
+}
+
+void operator delete( void* ptr, size_t /* size */ ) noexcept
+{
+  free( ptr ); // NOLINT(*-no-malloc)
+}
+
+namespace {
+
+enum class ChunkSizes
+{
+  Fixed,  // every write is exactly write_size bytes
+  Uniform // write sizes drawn uniformly from [1, 2 * write_size]
+};
+
+struct Config
+{
+  size_t capacity;
+  size_t write_size;
+  size_t read_size;
+  ChunkSizes chunks;
+};
+
+// Timings and allocation counts for one operation under one configuration
+class OpStats
+{
+  vector<uint64_t> latencies_ns_ {};
+  size_t bytes_ {};
+  size_t allocations_ {};
+  uint64_t total_ns_ {};
+
+public:
+  template<typename F>
+  void measure( F&& op )
+  {
+    const size_t allocations_before = allocation_count;
+    const auto start = steady_clock::now();
+    bytes_ += op();
+    const auto ns = duration_cast<nanoseconds>( steady_clock::now() - start ).count();
+    allocations_ += allocation_count - allocations_before;
+    total_ns_ += ns;
+    latencies_ns_.push_back( ns );
+  }
+
+  void reserve( size_t n ) { latencies_ns_.reserve( n ); }
+
+  size_t calls() const { return latencies_ns_.size(); }
+  double ns_per_op() const { return calls() ? static_cast<double>( total_ns_ ) / calls() : 0; }
+  double bytes_per_second() const { return total_ns_ ? 1e9 * static_cast<double>( bytes_ ) / total_ns_ : 0; }
+  double allocations_per_op() const { return calls() ? static_cast<double>( allocations_ ) / calls() : 0; }
+
+  uint64_t percentile( double p )
+  {
+    if ( latencies_ns_.empty() ) {
+      return 0;
+    }
+    const auto nth = latencies_ns_.begin() + static_cast<ptrdiff_t>( p * ( latencies_ns_.size() - 1 ) );
+    nth_element( latencies_ns_.begin(), nth, latencies_ns_.end() );
+    return *nth;
+  }
+};
+
+struct Result
+{
+  Config config;
+  string op;
+  OpStats stats;
+};
+
+string make_data( size_t len )
+{
+  default_random_engine rd { 789 };
+  uniform_int_distribution<char> ud;
+  string ret;
+  for ( size_t i = 0; i < len; ++i ) {
+    ret += ud( rd );
+  }
+  return ret;
+}
+
+vector<string> split( const string& data, const Config& config )
+{
+  default_random_engine rd { 1370 };
+  uniform_int_distribution<size_t> sizes { 1, 2 * config.write_size };
+  vector<string> ret;
+  for ( size_t i = 0; i < data.size(); ) {
+    const size_t len = config.chunks == ChunkSizes::Fixed ? config.write_size : sizes( rd );
+    ret.emplace_back( data.substr( i, len ) );
+    i += len;
+  }
+  return ret;
+}
+
+// Exercise Writer::push and Reader::peek/pop in lockstep, timing each call
+void bench_push_peek_pop( const string& data, const Config& config, vector<Result>& results )
+{
+  vector<string> chunks = split( data, config );
+  Result push { config, "push", {} };
+  Result peek_pop { config, "peek_pop", {} };
+  push.stats.reserve( chunks.size() );
+  peek_pop.stats.reserve( data.size() / min( config.read_size, config.capacity ) + chunks.size() );
+
+  ByteStream bs { config.capacity };
+  string output;
+  output.reserve( data.size() );
+
+  auto next = chunks.begin();
+  while ( not bs.reader().is_finished() ) {
+    if ( next == chunks.end() ) {
+      bs.writer().close();
+    } else if ( next->size() <= bs.writer().available_capacity() ) {
+      push.stats.measure( [&] {
+        const size_t len = next->size();
+        bs.writer().push( move( *next ) );
+        return len;
+      } );
+      ++next;
+    }
+
+    if ( bs.reader().bytes_buffered() ) {
+      peek_pop.stats.measure( [&] {
+        const auto peeked = bs.reader().peek().substr( 0, config.read_size );
+        output += peeked;
+        bs.reader().pop( peeked.size() );
+        return peeked.size();
+      } );
+    }
+  }
+
+  if ( output != data ) {
+    throw runtime_error( "Mismatch between data written and read" );
+  }
+
+  results.push_back( move( push ) );
+  results.push_back( move( peek_pop ) );
+}
+
+// Exercise the provided read() helper, which copies out of the stream
+void bench_read( const string& data, const Config& config, vector<Result>& results )
+{
+  vector<string> chunks = split( data, config );
+  Result read_op { config, "read", {} };
+
+  ByteStream bs { config.capacity };
+  string output;
+  string out;
+  output.reserve( data.size() );
+
+  auto next = chunks.begin();
+  while ( not bs.reader().is_finished() ) {
+    while ( next != chunks.end() and next->size() <= bs.writer().available_capacity() ) {
+      bs.writer().push( move( *next ) );
+      ++next;
+    }
+    if ( next == chunks.end() ) {
+      bs.writer().close();
+    }
+
+    read_op.stats.measure( [&] {
+      read( bs.reader(), config.read_size, out );
+      return out.size();
+    } );
+    output += out;
+  }
+
+  if ( output != data ) {
+    throw runtime_error( "Mismatch between data written and read()" );
+  }
+
+  results.push_back( move( read_op ) );
+}
+
+string_view chunks_name( ChunkSizes chunks )
+{
+  return chunks == ChunkSizes::Fixed ? "fixed" : "uniform";
+}
+
+void print_csv( vector<Result>& results )
+{
+  cout << "op,capacity,write_size,read_size,chunks,calls,ns_per_op,bytes_per_second,allocs_per_op,p50_ns,p99_ns\n";
+  for ( auto& r : results ) {
+    cout << r.op << "," << r.config.capacity << "," << r.config.write_size << "," << r.config.read_size << ","
+         << chunks_name( r.config.chunks ) << "," << r.stats.calls() << "," << fixed << setprecision( 2 )
+         << r.stats.ns_per_op() << "," << setprecision( 0 ) << r.stats.bytes_per_second() << ","
+         << setprecision( 3 ) << r.stats.allocations_per_op() << "," << r.stats.percentile( 0.5 ) << ","
+         << r.stats.percentile( 0.99 ) << "\n";
+  }
+}
+
+void print_json( vector<Result>& results )
+{
+  cout << "[\n";
+  for ( size_t i = 0; i < results.size(); ++i ) {
+    auto& r = results[i];
+    cout << "  {\"op\": \"" << r.op << "\", \"capacity\": " << r.config.capacity
+         << ", \"write_size\": " << r.config.write_size << ", \"read_size\": " << r.config.read_size
+         << ", \"chunks\": \"" << chunks_name( r.config.chunks ) << "\", \"calls\": " << r.stats.calls()
+         << ", \"ns_per_op\": " << fixed << setprecision( 2 ) << r.stats.ns_per_op()
+         << ", \"bytes_per_second\": " << setprecision( 0 ) << r.stats.bytes_per_second()
+         << ", \"allocs_per_op\": " << setprecision( 3 ) << r.stats.allocations_per_op()
+         << ", \"p50_ns\": " << r.stats.percentile( 0.5 ) << ", \"p99_ns\": " << r.stats.percentile( 0.99 ) << "}"
+         << ( i + 1 < results.size() ? ",\n" : "\n" );
+  }
+  cout << "]\n";
+}
+
+void program_body( string_view format, size_t input_len )
+{
+  const string data = make_data( input_len );
+  vector<Result> results;
+
+  for ( const size_t capacity : { 4096UL, 32768UL, 1048576UL } ) {
+    for ( const size_t write_size : { 16UL, 128UL, 1500UL, 16384UL } ) {
+      if ( write_size > capacity ) {
+        continue;
+      }
+      for ( const size_t read_size : { 64UL, 1500UL, 65536UL } ) {
+        for ( const auto chunks : { ChunkSizes::Fixed, ChunkSizes::Uniform } ) {
+          const Config config { capacity, write_size, read_size, chunks };
+          if ( chunks == ChunkSizes::Uniform and 2 * write_size > capacity ) {
+            continue;
+          }
+          bench_push_peek_pop( data, config, results );
+          bench_read( data, config, results );
+        }
+      }
+    }
+  }
+
+  if ( format == "json" ) {
+    print_json( results );
+  } else {
+    print_csv( results );
+  }
+}
+
+} // namespace
+
+// usage: byte_stream_benchmark [csv|json] [input_len]
+int main( int argc, char* argv[] )
+{
+  try {
+    const span<char*> args { argv, static_cast<size_t>( argc ) };
+    const string_view format = args.size() > 1 ? args[1] : "csv";
+    const size_t input_len = args.size() > 2 ? stoul( args[2] ) : 1000000;
+    if ( format != "csv" and format != "json" ) {
+      cerr << "Usage: " << args[0] << " [csv|json] [input_len]\n";
+      return EXIT_FAILURE;
+    }
+    program_body( format, input_len );
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -97,6 +97,21 @@ int main()
       test.execute( BytesBuffered { 1 } );
     }
 
+    {
+      ByteStreamTestHarness test { "peek_all-across-wraparound", 4 };
+
+      test.execute( Push { "abc" } );
+      test.execute( Pop { 2 } );
+      test.execute( Push { "def" } );
+      test.execute( BytesBuffered { 4 } );
+      test.execute( PeekAll { "cdef" } );
+      test.execute( Peek { "cdef" } );
+      test.execute( Pop { 3 } );
+      test.execute( PeekAll { "f" } );
+      test.execute( Pop { 1 } );
+      test.execute( PeekAll { "" } );
+    }
+
   } catch ( const exception& e ) {
     cerr << "Exception: " << e.what() << endl;
     return EXIT_FAILURE;
@@ -0,0 +1,94 @@
+#include "spsc_byte_stream.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <poll.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+// Sleep until the eventfd is readable, the way an EventLoop would
+void wait_for( FileDescriptor& fd )
+{
+  pollfd pfd { fd.fd_num(), POLLIN, 0 };
+  if ( ::poll( &pfd, 1, 1000 ) != 1 ) {
+    throw runtime_error( "timed out waiting for the other thread" );
+  }
+}
+
+void cross_thread_copy( const size_t input_len, const size_t capacity )
+{
+  const string data = [&] {
+    default_random_engine rd { input_len };
+    uniform_int_distribution<char> ud;
+    string ret;
+    for ( size_t i = 0; i < input_len; ++i ) {
+      ret += ud( rd );
+    }
+    return ret;
+  }();
+
+  SPSCByteStream stream { capacity };
+
+  thread producer { [&] {
+    string_view remaining = data;
+    while ( not remaining.empty() ) {
+      stream.clear_space_available();
+      const uint64_t accepted = stream.push( remaining.substr( 0, 777 ) );
+      remaining.remove_prefix( accepted );
+      if ( accepted == 0 ) {
+        wait_for( stream.space_available_fd() );
+      }
+    }
+    stream.close();
+  } };
+
+  string output;
+  try {
+    while ( not stream.is_finished() ) {
+      stream.clear_data_available();
+      const auto peeked = stream.peek();
+      if ( peeked.empty() ) {
+        if ( not stream.is_finished() ) {
+          wait_for( stream.data_available_fd() );
+        }
+        continue;
+      }
+      output += peeked.substr( 0, 1000 );
+      stream.pop( min<size_t>( peeked.size(), 1000 ) );
+    }
+  } catch ( ... ) {
+    producer.join();
+    throw;
+  }
+  producer.join();
+
+  if ( output != data ) {
+    throw runtime_error( "Mismatch between data written and read (capacity=" + to_string( capacity ) + ")" );
+  }
+  if ( stream.bytes_popped() != input_len or stream.bytes_pushed() != input_len ) {
+    throw runtime_error( "SPSCByteStream counters disagree with the amount of data copied" );
+  }
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    cross_thread_copy( 1000000, 4096 );
+    cross_thread_copy( 100000, 1000 );
+    cross_thread_copy( 10000, 1 );
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -107,6 +107,28 @@ struct PeekOnce : public Peek
   }
 };
 
+struct PeekAll : public Peek
+{
+  using Peek::Peek;
+
+  std::string description() const override { return "peek_all() gives \"" + Printer::prettify( output_ ) + "\""; }
+
+  void execute( ByteStream& bs ) const override
+  {
+    std::string got;
+    for ( const auto segment : bs.reader().peek_all() ) {
+      if ( segment.empty() ) {
+        throw ExpectationViolation { "Reader::peek_all() returned an empty segment" };
+      }
+      got += segment;
+    }
+    if ( got != output_ ) {
+      throw ExpectationViolation { "Expected \"" + Printer::prettify( output_ ) + "\" from peek_all(), "
+                                   + "but found \"" + Printer::prettify( got ) + "\"" };
+    }
+  }
+};
+
 struct IsClosed : public ConstExpectBool<ByteStream>
 {
   using ConstExpectBool::ConstExpectBool;
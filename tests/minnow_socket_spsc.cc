@@ -0,0 +1,127 @@
+#include "random.hh"
+#include "socket.hh"
+#include "tcp_config.hh"
+#include "tcp_minnow_socket.hh"
+#include "tuntap_adapter.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// Sleep until the eventfd is readable, the way an EventLoop would
+void wait_for( FileDescriptor& fd )
+{
+  pollfd pfd { fd.fd_num(), POLLIN, 0 };
+  if ( ::poll( &pfd, 1, 5000 ) != 1 ) {
+    throw runtime_error( "timed out waiting for the TCP thread" );
+  }
+}
+
+void write_all( TCPOverIPv4OverUDPMinnowSocket& socket, string_view data )
+{
+  while ( not data.empty() ) {
+    data.remove_prefix( socket.write( data ) );
+    if ( not data.empty() and socket.outbound_stream().available_capacity() == 0 ) {
+      wait_for( socket.outbound_stream().space_available_fd() );
+      socket.outbound_stream().clear_space_available();
+    }
+  }
+  socket.close();
+}
+
+string read_all( TCPOverIPv4OverUDPMinnowSocket& socket )
+{
+  string ret;
+  string buffer;
+  while ( not socket.eof() ) {
+    socket.read( buffer );
+    ret += buffer;
+    if ( buffer.empty() and socket.inbound_stream().bytes_buffered() == 0 and not socket.eof() ) {
+      wait_for( socket.inbound_stream().data_available_fd() );
+      socket.inbound_stream().clear_data_available();
+    }
+  }
+  return ret;
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    // two ends of a tunnel over loopback UDP
+    UDPSocket socket_a;
+    UDPSocket socket_b;
+    socket_a.bind( Address { "127.0.0.1", 0 } );
+    socket_b.bind( Address { "127.0.0.1", 0 } );
+    socket_a.connect( socket_b.local_address() );
+    socket_b.connect( socket_a.local_address() );
+
+    TCPConfig cfg;
+    cfg.rt_timeout = 100;
+
+    FdAdapterConfig client_cfg;
+    client_cfg.source = Address { "10.144.0.1", 3000 };
+    client_cfg.destination = Address { "10.144.0.2", 4000 };
+    FdAdapterConfig server_cfg;
+    server_cfg.source = client_cfg.destination;
+
+    // several times the streams' capacity, so both sides have to wait for room
+    string request( 3 * TCPConfig::DEFAULT_CAPACITY, 0 );
+    for ( auto& ch : request ) {
+      ch = static_cast<char>( rd() );
+    }
+    const string reply = "received " + to_string( request.size() ) + " bytes";
+
+    TCPOverIPv4OverUDPMinnowSocket client { TCPOverIPv4OverUDPFdAdapter { std::move( socket_a ) } };
+    TCPOverIPv4OverUDPMinnowSocket server { TCPOverIPv4OverUDPFdAdapter { std::move( socket_b ) } };
+
+    string received;
+    exception_ptr server_error;
+    thread server_thread { [&] {
+      try {
+        server.listen_and_accept( cfg, server_cfg );
+        received = read_all( server );
+        write_all( server, "received " + to_string( received.size() ) + " bytes" );
+        server.wait_until_closed();
+      } catch ( ... ) {
+        server_error = current_exception();
+      }
+    } };
+
+    client.connect( cfg, client_cfg );
+    write_all( client, request );
+    const string response = read_all( client );
+    client.wait_until_closed();
+    server_thread.join();
+
+    if ( server_error ) {
+      rethrow_exception( server_error );
+    }
+    if ( received != request ) {
+      throw runtime_error( "the server received " + to_string( received.size() ) + " bytes that differ from the "
+                           + to_string( request.size() ) + " the client wrote" );
+    }
+    if ( response != reply ) {
+      throw runtime_error( "the client received \"" + response + "\" instead of \"" + reply + "\"" );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#include "random.hh"
+#include "tcp_config.hh"
+#include "tcp_peer.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    TCPConfig cfg;
+    cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+    const Wrap32 server_isn { static_cast<uint32_t>( rd() ) };
+
+    TCPPeer peer { cfg };
+    vector<vector<TCPMessage>> batches;
+    const TCPPeer::BatchTransmitFunction transmit
+      = [&]( span<const TCPMessage> batch ) { batches.emplace_back( batch.begin(), batch.end() ); };
+
+    peer.outbound_writer().push( string( 10000, 'x' ) );
+    peer.push( transmit );
+    if ( batches.size() != 1 or batches.back().size() != 1 or not batches.back().front().sender.SYN ) {
+      throw runtime_error( "expected the SYN on its own" );
+    }
+
+    // the SYN/ACK opens the window: the whole burst is handed over in one call
+    peer.receive( TCPMessage { { server_isn, true }, { cfg.isn + 1, 64000 } }, transmit );
+    if ( batches.size() != 2 ) {
+      throw runtime_error( "expected one batch after the SYN/ACK, got " + to_string( batches.size() - 1 ) );
+    }
+    if ( batches.back().size() != 10 ) {
+      throw runtime_error( "expected ten segments in the batch, got " + to_string( batches.back().size() ) );
+    }
+    uint32_t offset = 1;
+    for ( const auto& msg : batches.back() ) {
+      if ( msg.sender.seqno != cfg.isn + offset or msg.sender.payload.size() != 1000
+           or msg.receiver.ackno != optional { server_isn + 1 } ) {
+        throw runtime_error( "unexpected segment in the batch" );
+      }
+      offset += 1000;
+    }
+
+    // nothing to send: no call at all
+    peer.tick( 1, transmit );
+    if ( batches.size() != 2 ) {
+      throw runtime_error( "an empty batch was handed over" );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+#include "random.hh"
+#include "tcp_config.hh"
+#include "tcp_peer.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// A TCPPeer that has accepted a connection from `peer_isn` and had its SYN/ACK acknowledged
+struct PeerAndOutput
+{
+  TCPConfig cfg;
+  Wrap32 peer_isn;
+  TCPPeer peer { cfg };
+  queue<TCPMessage> output {};
+  uint32_t next_seqno {};
+
+  PeerAndOutput( const TCPConfig& config, Wrap32 isn ) : cfg( config ), peer_isn( isn ), peer( config )
+  {
+    receive( TCPMessage { { peer_isn, true }, { nullopt, 64000 } } );
+    expect_ack( "SYN", 1 );
+    next_seqno = 1;
+    receive( TCPMessage { { peer_isn + 1 }, { cfg.isn + 1, 64000 } } );
+    expect_silence( "ACK of our SYN" );
+  }
+
+  auto transmit()
+  {
+    return [&]( const TCPMessage& msg ) { output.push( msg ); };
+  }
+
+  void receive( TCPMessage msg ) { peer.receive( std::move( msg ), transmit() ); }
+
+  // Deliver `len` bytes of in-order data (or, with `offset`, data that many bytes past the next seqno)
+  void data( size_t len, uint32_t offset = 0, bool fin = false )
+  {
+    receive(
+      TCPMessage { { peer_isn + next_seqno + offset, false, string( len, 'x' ), fin }, { cfg.isn + 1, 64000 } } );
+    if ( offset == 0 ) {
+      next_seqno += len + fin;
+    }
+  }
+
+  void tick( uint64_t ms ) { peer.tick( ms, transmit() ); }
+
+  void expect_ack( const string& what, uint32_t ackno )
+  {
+    if ( output.empty() ) {
+      throw runtime_error( what + ": expected an ACK, but nothing was sent" );
+    }
+    const TCPMessage msg = output.front();
+    output.pop();
+    if ( msg.receiver.ackno != optional { peer_isn + ackno } ) {
+      throw runtime_error( what + ": ACK had the wrong ackno" );
+    }
+  }
+
+  void expect_silence( const string& what )
+  {
+    if ( not output.empty() ) {
+      throw runtime_error( what + ": expected no segment, but one was sent" );
+    }
+  }
+};
+
+} // namespace
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    TCPConfig cfg;
+    cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+    cfg.delayed_ack_ms = 40;
+
+    {
+      PeerAndOutput test { cfg, Wrap32 { static_cast<uint32_t>( rd() ) } };
+
+      // every second full-sized segment is acknowledged
+      test.data( 1000 );
+      test.expect_silence( "first full segment" );
+      test.data( 1000 );
+      test.expect_ack( "second full segment", 2001 );
+
+      // a lone segment is acknowledged when the timer expires
+      test.data( 1000 );
+      test.expect_silence( "third full segment" );
+      if ( test.peer.ms_until_next_send() != optional<uint64_t> { 40 } ) {
+        throw runtime_error( "ms_until_next_send should report the delayed-ACK deadline" );
+      }
+      test.tick( 39 );
+      test.expect_silence( "39 ms after the third segment" );
+      test.tick( 1 );
+      test.expect_ack( "delayed-ACK timer", 3001 );
+      test.tick( 100 );
+      test.expect_silence( "nothing left to acknowledge" );
+    }
+
+    {
+      PeerAndOutput test { cfg, Wrap32 { static_cast<uint32_t>( rd() ) } };
+
+      // "full-sized" follows the peer's segments, even when its MSS is smaller than ours (no stretch ACKs)
+      test.data( 536 );
+      test.expect_silence( "first 536-byte segment" );
+      test.data( 536 );
+      test.expect_ack( "second 536-byte segment", 1073 );
+
+      // a short segment is not full-sized, so it waits for the timer
+      test.data( 100 );
+      test.data( 536 );
+      test.expect_silence( "one full segment and a short one" );
+      test.data( 536 );
+      test.expect_ack( "second full segment after the short one", 2245 );
+    }
+
+    {
+      PeerAndOutput test { cfg, Wrap32 { static_cast<uint32_t>( rd() ) } };
+
+      // out-of-order data is acknowledged immediately (a duplicate ACK for the sender's fast retransmit)
+      test.data( 100 );
+      test.expect_silence( "small in-order segment" );
+      test.data( 100, 400 );
+      test.expect_ack( "out-of-order segment", 101 );
+
+      // so is the segment that fills the hole
+      test.data( 400 );
+      test.expect_ack( "hole-filling segment", 601 );
+      test.next_seqno = 601;
+
+      // and a FIN
+      test.data( 100 );
+      test.expect_silence( "in-order segment before the FIN" );
+      test.data( 0, 0, true );
+      test.expect_ack( "FIN", 702 );
+    }
+
+    {
+      PeerAndOutput test { cfg, Wrap32 { static_cast<uint32_t>( rd() ) } };
+
+      // outgoing data carries the pending ACK
+      test.data( 100 );
+      test.expect_silence( "small in-order segment" );
+      test.peer.outbound_writer().push( "hello" );
+      test.peer.push( test.transmit() );
+      if ( test.output.empty() or test.output.front().sender.payload != "hello" ) {
+        throw runtime_error( "expected outgoing data" );
+      }
+      test.expect_ack( "piggybacked on data", 101 );
+      test.tick( 40 );
+      test.expect_silence( "the piggybacked ACK cancelled the timer" );
+    }
+
+    {
+      cfg.delayed_ack_ms = 0;
+      PeerAndOutput test { cfg, Wrap32 { static_cast<uint32_t>( rd() ) } };
+      test.data( 1000 );
+      test.expect_ack( "delayed ACKs disabled", 1001 );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
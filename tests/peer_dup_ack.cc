@@ -0,0 +1,73 @@
+#include "random.hh"
+#include "tcp_config.hh"
+#include "tcp_peer.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    TCPConfig cfg;
+    cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+    cfg.dup_ack_threshold = 3;
+    const Wrap32 peer_isn { static_cast<uint32_t>( rd() ) };
+
+    TCPPeer peer { cfg };
+    queue<TCPMessage> output;
+    const TCPPeer::TransmitFunction transmit = [&]( const TCPMessage& msg ) { output.push( msg ); };
+
+    // accept a connection, then send three segments
+    peer.receive( TCPMessage { { peer_isn, true }, { nullopt, 64000 } }, transmit );
+    peer.receive( TCPMessage { { peer_isn + 1 }, { cfg.isn + 1, 64000 } }, transmit );
+    peer.outbound_writer().push( string( 3000, 'x' ) );
+    peer.push( transmit );
+    output = {};
+
+    // the other side sends its own data before ours arrives: each of its segments repeats our snd_una
+    uint32_t peer_seqno = 1;
+    for ( int i = 0; i < 4; ++i ) {
+      peer.receive( TCPMessage { { peer_isn + peer_seqno, false, string( 500, 'y' ) }, { cfg.isn + 1, 64000 } },
+                    transmit );
+      peer_seqno += 500;
+    }
+    while ( not output.empty() ) {
+      if ( output.front().sender.payload.size() > 0 ) {
+        throw runtime_error( "data segments from the peer triggered a retransmission" );
+      }
+      output.pop();
+    }
+    if ( peer.info().fast_retransmits != 0 ) {
+      throw runtime_error( "data segments from the peer counted as duplicate ACKs" );
+    }
+    if ( peer.inbound_reader().bytes_buffered() != 2000 ) {
+      throw runtime_error( "the peer's data was not received" );
+    }
+
+    // three pure duplicate ACKs still trigger fast retransmit
+    for ( int i = 0; i < 3; ++i ) {
+      peer.receive( TCPMessage { { peer_isn + peer_seqno }, { cfg.isn + 1, 64000 } }, transmit );
+    }
+    if ( output.empty() or output.front().sender.seqno != cfg.isn + 1
+         or output.front().sender.payload.size() != 1000 ) {
+      throw runtime_error( "three duplicate ACKs did not trigger fast retransmit" );
+    }
+    if ( peer.info().fast_retransmits != 1 ) {
+      throw runtime_error( "expected one fast retransmit" );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
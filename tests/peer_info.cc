@@ -0,0 +1,110 @@
+#include "random.hh"
+#include "tcp_config.hh"
+#include "tcp_info.hh"
+#include "tcp_peer.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+void expect( const string& what, uint64_t expected, uint64_t actual )
+{
+  if ( expected != actual ) {
+    throw runtime_error( what + " should have been " + to_string( expected ) + ", but was " + to_string( actual ) );
+  }
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+      cfg.recv_capacity = 3000;
+      cfg.rt_timeout = 100;
+      const Wrap32 peer_isn { static_cast<uint32_t>( rd() ) };
+
+      TCPPeer peer { cfg };
+      const auto ignore = []( const TCPMessage& ) {};
+
+      // handshake, then one segment in order, one out of order, and one that fills the window
+      peer.receive( TCPMessage { { peer_isn, true }, { nullopt, 64000 } }, ignore );
+      peer.receive( TCPMessage { { peer_isn + 1, false, string( 1000, 'a' ) }, { cfg.isn + 1, 64000 } }, ignore );
+      peer.receive( TCPMessage { { peer_isn + 2001, false, string( 500, 'c' ) }, { cfg.isn + 1, 64000 } }, ignore );
+      TCPInfo info = peer.info();
+      expect( "segments_received", 3, info.segments_received );
+      expect( "bytes_received", 1500, info.bytes_received );
+      expect( "out_of_order_segments", 1, info.out_of_order_segments );
+      expect( "reassembler_pending", 500, info.reassembler_pending );
+      expect( "segments_sent", 3, info.segments_sent ); // SYN/ACK and two ACKs
+
+      peer.receive( TCPMessage { { peer_isn + 1001, false, string( 2000, 'b' ) }, { cfg.isn + 1, 64000 } },
+                    ignore );
+      info = peer.info();
+      expect( "reassembler_pending", 0, info.reassembler_pending );
+      peer.tick( 30, ignore );
+      peer.inbound_reader().pop( 3000 );
+      peer.tick( 20, ignore );
+      expect( "recv_window_zero_ms", 30, peer.info().recv_window_zero_ms );
+
+      // data that is never acknowledged: one timeout, one retransmission
+      peer.outbound_writer().push( "hello" );
+      peer.push( ignore );
+      peer.tick( 100, ignore );
+      info = peer.info();
+      expect( "timeouts", 1, info.timeouts );
+      expect( "segments_retransmitted", 1, info.segments_retransmitted );
+      expect( "bytes_retransmitted", 5, info.bytes_retransmitted );
+      expect( "bytes_sent", 10, info.bytes_sent );
+      expect( "bytes_in_flight", 5, info.bytes_in_flight );
+      expect( "rto_ms", 200, info.rto_ms );
+    }
+
+    {
+      // a reader never sees a half-written snapshot
+      TCPInfoSnapshot snapshot;
+      atomic_bool done { false };
+      thread writer { [&] {
+        for ( uint64_t i = 1; i <= 100000; ++i ) {
+          TCPInfo info;
+          info.segments_sent = i;
+          info.bytes_sent = i;
+          info.srtt_ms = static_cast<double>( i );
+          snapshot.publish( info );
+        }
+        done = true;
+      } };
+
+      uint64_t last = 0;
+      while ( not done ) {
+        const TCPInfo info = snapshot.load();
+        if ( info.segments_sent != info.bytes_sent or info.srtt_ms != static_cast<double>( info.bytes_sent )
+             or info.segments_sent < last ) {
+          writer.join();
+          throw runtime_error( "torn or stale TCPInfo snapshot" );
+        }
+        last = info.segments_sent;
+      }
+      writer.join();
+      expect( "final snapshot", 100000, snapshot.load().segments_sent );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include "random.hh"
+#include "tcp_config.hh"
+#include "tcp_peer.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    TCPConfig cfg;
+    cfg.isn = Wrap32 { static_cast<uint32_t>( rd() ) };
+    cfg.recv_capacity = 2000;
+    const Wrap32 peer_isn { static_cast<uint32_t>( rd() ) };
+
+    TCPPeer peer { cfg };
+    vector<TCPMessage> sent;
+    const auto collect = [&]( const TCPMessage& msg ) { sent.push_back( msg ); };
+
+    peer.receive( TCPMessage { { peer_isn, true }, { nullopt, 64000 } }, collect );
+    peer.receive( TCPMessage { { peer_isn + 1, false, string( 2000, 'x' ) }, { cfg.isn + 1, 64000 } }, collect );
+    if ( sent.size() != 2 or sent.back().receiver.window_size != 0 ) {
+      throw runtime_error( "a full buffer should be acknowledged with a zero window" );
+    }
+
+    // Reading less than min(MSS, half the buffer) does not announce the small window (SWS avoidance).
+    peer.inbound_reader().pop( 500 );
+    peer.tick( 10, collect );
+    if ( sent.size() != 2 ) {
+      throw runtime_error( "window update sent before the window opened far enough" );
+    }
+
+    peer.inbound_reader().pop( 500 );
+    peer.tick( 10, collect );
+    if ( sent.size() != 3 or sent.back().receiver.window_size != 1000
+         or sent.back().receiver.ackno != peer_isn + 2001 or sent.back().sender.sequence_length() != 0 ) {
+      throw runtime_error( "expected a pure ACK announcing the reopened window" );
+    }
+
+    peer.tick( 10, collect );
+    peer.inbound_reader().pop( 1000 );
+    peer.tick( 10, collect );
+    if ( sent.size() != 3 ) {
+      throw runtime_error( "window update repeated for a window that was already open" );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include "reassembler_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+  try {
+    {
+      ReassemblerTestHarness test { "range limit drops farthest", 65000, 2 };
+
+      test.execute( Insert { "b", 1 } );
+      test.execute( Insert { "d", 3 } );
+      test.execute( HeldRanges { 2 } );
+      test.execute( BytesPending { 2 } );
+      test.execute( RangesDropped { 0 } );
+
+      test.execute( Insert { "f", 5 } );
+      test.execute( HeldRanges { 2 } );
+      test.execute( BytesPending { 2 } );
+      test.execute( RangesDropped { 1 } );
+      test.execute( BytesDropped { 1 } );
+
+      test.execute( Insert { "a", 0 } );
+      test.execute( BytesPushed( 2 ) );
+      test.execute( Insert { "c", 2 } );
+      test.execute( BytesPushed( 4 ) );
+      test.execute( ReadAll( "abcd" ) );
+      test.execute( HeldRanges { 0 } );
+
+      // the dropped byte has to be sent again
+      test.execute( Insert { "ef", 4 } );
+      test.execute( BytesPushed( 6 ) );
+      test.execute( ReadAll( "ef" ) );
+      test.execute( RangesDropped { 1 } );
+      test.execute( BytesDropped { 1 } );
+    }
+
+    {
+      ReassemblerTestHarness test { "range limit keeps nearer ranges", 65000, 2 };
+
+      test.execute( Insert { "xx", 10 } );
+      test.execute( Insert { "yy", 20 } );
+      test.execute( Insert { "b", 1 } );
+      test.execute( HeldRanges { 2 } );
+      test.execute( BytesDropped { 2 } );
+      test.execute( BytesPending { 3 } );
+
+      test.execute( Insert { "a", 0 } );
+      test.execute( BytesPushed( 2 ) );
+      test.execute( ReadAll( "ab" ) );
+      test.execute( HeldRanges { 1 } );
+      test.execute( BytesPending { 2 } );
+    }
+
+    {
+      ReassemblerTestHarness test { "adjacent inserts coalesce under limit", 65000, 1 };
+
+      for ( uint64_t i = 1; i < 100; ++i ) {
+        test.execute( Insert { string( 1, static_cast<char>( 'a' + i % 26 ) ), i } );
+      }
+      test.execute( HeldRanges { 1 } );
+      test.execute( BytesDropped { 0 } );
+      test.execute( BytesPending { 99 } );
+
+      test.execute( Insert { "a", 0 }.is_last( false ) );
+      test.execute( BytesPushed( 100 ) );
+      test.execute( BytesPending { 0 } );
+    }
+
+    {
+      ReassemblerTestHarness test { "dropped last substring is accepted again", 65000, 1 };
+
+      test.execute( Insert { "b", 1 } );
+      test.execute( Insert { "d", 3 }.is_last() );
+      test.execute( BytesDropped { 1 } );
+
+      test.execute( Insert { "a", 0 } );
+      test.execute( BytesPushed( 2 ) );
+      test.execute( IsFinished { false } );
+
+      test.execute( Insert { "cd", 2 }.is_last() );
+      test.execute( ReadAll( "abcd" ) );
+      test.execute( IsFinished { true } );
+    }
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
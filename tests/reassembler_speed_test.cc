@@ -13,9 +13,10 @@
 using namespace std;
 using namespace std::chrono;
 
-void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-parameters)
-                 const size_t capacity,     // NOLINT(bugprone-easily-swappable-parameters)
-                 const size_t random_seed ) // NOLINT(bugprone-easily-swappable-parameters)
+void speed_test( const size_t num_chunks,  // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t capacity,    // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t random_seed, // NOLINT(bugprone-easily-swappable-parameters)
+                 const bool reorder )
 {
   // Generate the data to be written
   const string data = [&] {
@@ -31,6 +32,10 @@ void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-
   // Split the data into segments before writing
   queue<tuple<uint64_t, string, bool>> split_data;
   for ( size_t i = 0; i < data.size(); i += capacity ) {
+    if ( not reorder ) {
+      split_data.emplace( i, data.substr( i, capacity ), i + capacity >= data.size() );
+      continue;
+    }
     split_data.emplace( i + 2, data.substr( i + 2, capacity * 2 ), i + 2 + capacity * 2 >= data.size() );
     split_data.emplace( i, data.substr( i, capacity * 2 ), i + capacity * 2 >= data.size() );
     split_data.emplace( i + 1, data.substr( i + 1, capacity * 2 ), i + 1 + capacity * 2 >= data.size() );
@@ -71,12 +76,19 @@ void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-
   fstream debug_output;
   debug_output.open( "/dev/tty" );
 
-  cout << "Reassembler to ByteStream with capacity=" << capacity << " reached " << fixed << setprecision( 2 )
-       << gigabits_per_second << " Gbit/s.\n";
+  cout << "Reassembler to ByteStream with capacity=" << capacity << ( reorder ? "" : " (in order)" ) << " reached "
+       << fixed << setprecision( 2 ) << gigabits_per_second << " Gbit/s.\n";
 
   debug_output << "             Reassembler throughput: " << fixed << setprecision( 2 ) << gigabits_per_second
                << " Gbit/s\n";
 
+  if constexpr ( kInstrumented ) {
+    const auto& stats = reassembler.stats();
+    cout << "  inserts=" << stats.segments_inserted << " fast_path=" << stats.fast_path_hits
+         << " held_ranges=" << stats.map_nodes_created << " merges=" << stats.chunk_merges
+         << " window_allocations=" << stats.allocations << " window_bytes_copied=" << stats.bytes_copied << "\n";
+  }
+
   if ( gigabits_per_second < 0.1 ) {
     throw runtime_error( "Reassembler did not meet minimum speed of 0.1 Gbit/s." );
   }
@@ -84,7 +96,8 @@ void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-
 
 void program_body()
 {
-  speed_test( 10000, 1500, 1370 );
+  speed_test( 10000, 1500, 1370, true );
+  speed_test( 10000, 1500, 1370, false );
 }
 
 int main()
@@ -33,6 +33,13 @@ public:
                    { Reassembler { ByteStream { capacity } } } )
   {}
 
+  ReassemblerTestHarness( std::string test_name, uint64_t capacity, uint64_t max_held_ranges )
+    : TestHarness( move( test_name ),
+                   "capacity=" + std::to_string( capacity )
+                     + ", max_held_ranges=" + std::to_string( max_held_ranges ),
+                   { Reassembler { ByteStream { capacity }, max_held_ranges } } )
+  {}
+
   template<std::derived_from<TestStep<ByteStream>> T>
   void execute( const T& test )
   {
@@ -49,6 +56,27 @@ struct BytesPending : public ConstExpectNumber<Reassembler, uint64_t>
   uint64_t value( const Reassembler& r ) const override { return r.bytes_pending(); }
 };
 
+struct HeldRanges : public ConstExpectNumber<Reassembler, uint64_t>
+{
+  using ConstExpectNumber::ConstExpectNumber;
+  std::string name() const override { return "held_ranges"; }
+  uint64_t value( const Reassembler& r ) const override { return r.held_ranges(); }
+};
+
+struct RangesDropped : public ConstExpectNumber<Reassembler, uint64_t>
+{
+  using ConstExpectNumber::ConstExpectNumber;
+  std::string name() const override { return "ranges_dropped"; }
+  uint64_t value( const Reassembler& r ) const override { return r.ranges_dropped(); }
+};
+
+struct BytesDropped : public ConstExpectNumber<Reassembler, uint64_t>
+{
+  using ConstExpectNumber::ConstExpectNumber;
+  std::string name() const override { return "bytes_dropped"; }
+  uint64_t value( const Reassembler& r ) const override { return r.bytes_dropped(); }
+};
+
 struct Insert : public Action<Reassembler>
 {
   std::string data_;
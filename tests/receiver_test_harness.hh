@@ -8,6 +8,7 @@
 #include <optional>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 template<std::derived_from<TestStep<Reassembler>> T>
 struct DirectReassemblerTest : public TestStep<TCPReceiver>
@@ -40,10 +41,10 @@ struct DirectByteStreamTest : public TestStep<TCPReceiver>
 class TCPReceiverTestHarness : public TestHarness<TCPReceiver>
 {
 public:
-  TCPReceiverTestHarness( std::string test_name, uint64_t capacity )
+  TCPReceiverTestHarness( std::string test_name, uint64_t capacity, bool offer_sack = false )
     : TestHarness( move( test_name ),
-                   "capacity=" + std::to_string( capacity ),
-                   { TCPReceiver { Reassembler { ByteStream { capacity } } } } )
+                   "capacity=" + std::to_string( capacity ) + ( offer_sack ? ", SACK offered" : "" ),
+                   { TCPReceiver { Reassembler { ByteStream { capacity } }, offer_sack } } )
   {}
 
   template<std::derived_from<TestStep<Reassembler>> T>
@@ -75,6 +76,20 @@ struct ExpectAckno : public ExpectNumber<TCPReceiver, std::optional<Wrap32>>
   std::optional<Wrap32> value( TCPReceiver& rs ) const override { return rs.send().ackno; }
 };
 
+struct ExpectTimestampEcho : public ExpectNumber<TCPReceiver, std::optional<uint32_t>>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "timestamp_echo"; }
+  std::optional<uint32_t> value( TCPReceiver& rs ) const override { return rs.send().timestamp_echo; }
+};
+
+struct ExpectPAWSRejected : public ExpectNumber<TCPReceiver, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "paws_rejected"; }
+  uint64_t value( TCPReceiver& rs ) const override { return rs.paws_rejected(); }
+};
+
 struct ExpectReset : public ExpectBool<TCPReceiver>
 {
   using ExpectBool::ExpectBool;
@@ -83,6 +98,36 @@ struct ExpectReset : public ExpectBool<TCPReceiver>
   bool value( TCPReceiver& rs ) const override { return rs.send().RST; }
 };
 
+struct ExpectSACKBlocks : public Expectation<TCPReceiver>
+{
+  std::vector<std::pair<Wrap32, Wrap32>> blocks_;
+
+  explicit ExpectSACKBlocks( std::vector<std::pair<Wrap32, Wrap32>> blocks ) : blocks_( std::move( blocks ) ) {}
+
+  static std::string describe( const std::vector<std::pair<Wrap32, Wrap32>>& blocks )
+  {
+    std::string ret = "[";
+    for ( const auto& [left, right] : blocks ) {
+      ret += " [" + to_string( left ) + ", " + to_string( right ) + ")";
+    }
+    return ret + " ]";
+  }
+
+  std::string description() const override { return "SACK blocks are " + describe( blocks_ ); }
+
+  void execute( TCPReceiver& rs ) const override
+  {
+    std::vector<std::pair<Wrap32, Wrap32>> got;
+    for ( const auto& block : rs.send().sack_blocks ) {
+      got.emplace_back( block.left, block.right );
+    }
+    if ( got != blocks_ ) {
+      throw ExpectationViolation( "TCPReceiver reported SACK blocks " + describe( got ) + ", but expected "
+                                  + describe( blocks_ ) );
+    }
+  }
+};
+
 struct ExpectAcknoBetween : public Expectation<TCPReceiver>
 {
   Wrap32 isn_;
@@ -155,6 +200,24 @@ struct SegmentArrives : public Action<TCPReceiver>
     return *this;
   }
 
+  SegmentArrives& with_window_scale( uint8_t shift )
+  {
+    msg_.window_scale = shift;
+    return *this;
+  }
+
+  SegmentArrives& with_timestamp( uint32_t tsval )
+  {
+    msg_.timestamp = tsval;
+    return *this;
+  }
+
+  SegmentArrives& with_sack_permitted()
+  {
+    msg_.sack_permitted = true;
+    return *this;
+  }
+
   SegmentArrives& without_ackno()
   {
     ackno_expected_ = HasAckno { false };
@@ -181,6 +244,9 @@ struct SegmentArrives : public Action<TCPReceiver>
     if ( msg_.FIN ) {
       ss << " +FIN";
     }
+    if ( msg_.timestamp.has_value() ) {
+      ss << " TSval=" << msg_.timestamp.value();
+    }
     ss << ")";
 
     if ( ackno_expected_.value_ ) {
@@ -0,0 +1,124 @@
+#include "parser.hh"
+#include "random.hh"
+#include "receiver_test_harness.hh"
+#include "tcp_segment.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "SACK blocks, most recent first", 4000, true };
+      test.execute( SegmentArrives {}.with_syn().with_sack_permitted().with_seqno( isn ) );
+      test.execute( ExpectSACKBlocks { {} } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( ExpectSACKBlocks { { { Wrap32 { isn + 5 }, Wrap32 { isn + 9 } } } } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 13 ).with_data( "mn" ) );
+      test.execute( ExpectSACKBlocks {
+        { { Wrap32 { isn + 13 }, Wrap32 { isn + 15 } }, { Wrap32 { isn + 5 }, Wrap32 { isn + 9 } } } } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 9 ).with_data( "ij" ) );
+      test.execute( ExpectSACKBlocks {
+        { { Wrap32 { isn + 5 }, Wrap32 { isn + 11 } }, { Wrap32 { isn + 13 }, Wrap32 { isn + 15 } } } } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 11 } } );
+      test.execute( ExpectSACKBlocks { { { Wrap32 { isn + 13 }, Wrap32 { isn + 15 } } } } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "SACK blocks capped", 4000, true };
+      test.execute( SegmentArrives {}.with_syn().with_sack_permitted().with_seqno( isn ) );
+      for ( uint32_t i = 0; i < 6; ++i ) {
+        test.execute( SegmentArrives {}.with_seqno( isn + 2 + 2 * i ).with_data( "x" ) );
+      }
+      test.execute( ExpectSACKBlocks { { { Wrap32 { isn + 12 }, Wrap32 { isn + 13 } },
+                                         { Wrap32 { isn + 10 }, Wrap32 { isn + 11 } },
+                                         { Wrap32 { isn + 8 }, Wrap32 { isn + 9 } },
+                                         { Wrap32 { isn + 6 }, Wrap32 { isn + 7 } } } } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "No SACK blocks unless the peer's SYN permitted them", 4000, true };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 1 } } );
+      test.execute( ExpectSACKBlocks { {} } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "No SACK blocks unless our SYN offered them", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_sack_permitted().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( ExpectSACKBlocks { {} } );
+    }
+
+    {
+      // SACK-permitted rides on the SYN and nowhere else
+      TCPSegment seg;
+      seg.message.sender.seqno = Wrap32 { 1000 };
+      seg.message.sender.SYN = true;
+      seg.message.sender.sack_permitted = true;
+      seg.compute_checksum( 0 );
+
+      TCPSegment parsed;
+      if ( not parse( parsed, serialize( seg ), 0 ) or not parsed.message.sender.sack_permitted ) {
+        throw runtime_error( "SACK-permitted did not survive a round trip on a SYN" );
+      }
+
+      seg.message.sender.SYN = false;
+      seg.compute_checksum( 0 );
+      TCPSegment parsed_data;
+      if ( not parse( parsed_data, serialize( seg ), 0 ) or parsed_data.message.sender.sack_permitted ) {
+        throw runtime_error( "SACK-permitted must not be sent on a segment without SYN" );
+      }
+    }
+
+    {
+      // SACK blocks survive a round trip through the TCP header's option space
+      TCPSegment seg;
+      seg.message.sender.seqno = Wrap32 { 1000 };
+      seg.message.sender.payload = "hello";
+      seg.message.receiver.ackno = Wrap32 { 77 };
+      seg.message.receiver.window_size = 1234;
+      for ( uint32_t i = 0; i < 6; ++i ) {
+        seg.message.receiver.sack_blocks.push_back( { Wrap32 { 100 + 10 * i }, Wrap32 { 105 + 10 * i } } );
+      }
+      seg.compute_checksum( 0 );
+
+      TCPSegment parsed;
+      if ( not parse( parsed, serialize( seg ), 0 ) ) {
+        throw runtime_error( "could not parse a serialized segment carrying SACK blocks" );
+      }
+      if ( parsed.message.sender.payload != "hello" or parsed.message.receiver.window_size != 1234
+           or parsed.message.receiver.ackno != Wrap32 { 77 } ) {
+        throw runtime_error( "SACK option corrupted the rest of the segment" );
+      }
+      if ( parsed.message.receiver.sack_blocks.size() != TCPReceiverMessage::MAX_SACK_BLOCKS ) {
+        throw runtime_error( "expected the serialized SACK option to be cut to MAX_SACK_BLOCKS blocks" );
+      }
+      for ( uint32_t i = 0; i < TCPReceiverMessage::MAX_SACK_BLOCKS; ++i ) {
+        if ( not( parsed.message.receiver.sack_blocks[i].left == Wrap32 { 100 + 10 * i } )
+             or not( parsed.message.receiver.sack_blocks[i].right == Wrap32 { 105 + 10 * i } ) ) {
+          throw runtime_error( "SACK block " + to_string( i ) + " did not survive the round trip" );
+        }
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
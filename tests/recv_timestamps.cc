@@ -0,0 +1,120 @@
+#include "parser.hh"
+#include "random.hh"
+#include "receiver_test_harness.hh"
+#include "tcp_segment.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "Echo the timestamp of the segment that advanced the ackno", 4000 };
+      test.execute( ExpectTimestampEcho { nullopt } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_timestamp( 100 ) );
+      test.execute( ExpectTimestampEcho { 100 } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abc" ).with_timestamp( 110 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+      test.execute( ExpectTimestampEcho { 110 } );
+
+      // an out-of-order segment doesn't change the echo
+      test.execute( SegmentArrives {}.with_seqno( isn + 7 ).with_data( "ghi" ).with_timestamp( 130 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+      test.execute( ExpectTimestampEcho { 110 } );
+
+      // the segment that fills the hole does
+      test.execute( SegmentArrives {}.with_seqno( isn + 4 ).with_data( "def" ).with_timestamp( 140 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 10 } } );
+      test.execute( ExpectTimestampEcho { 140 } );
+      test.execute( ReadAll { "abcdefghi" } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "PAWS discards segments with stale timestamps", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_timestamp( 1000 ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abc" ).with_timestamp( 1010 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+
+      // an old duplicate that looks like new data (its seqno wrapped around) is dropped
+      test.execute( SegmentArrives {}.with_seqno( isn + 4 ).with_data( "old" ).with_timestamp( 900 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+      test.execute( ExpectPAWSRejected { 1 } );
+      test.execute( ExpectTimestampEcho { 1010 } );
+
+      // an equal timestamp is still acceptable
+      test.execute( SegmentArrives {}.with_seqno( isn + 4 ).with_data( "new" ).with_timestamp( 1010 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 7 } } );
+      test.execute( ExpectPAWSRejected { 1 } );
+      test.execute( ReadAll { "abcnew" } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "PAWS compares timestamps modulo 2^32", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_timestamp( UINT32_MAX - 5 ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abc" ).with_timestamp( 10 ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+      test.execute( ExpectTimestampEcho { 10 } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 4 ).with_data( "def" ).with_timestamp( UINT32_MAX ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4 } } );
+      test.execute( ExpectPAWSRejected { 1 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "An echoed timestamp leaves room for three SACK blocks", 4000, true };
+      test.execute( SegmentArrives {}.with_syn().with_sack_permitted().with_seqno( isn ).with_timestamp( 1 ) );
+      for ( uint32_t i = 0; i < 4; ++i ) {
+        test.execute( SegmentArrives {}.with_seqno( isn + 2 + 2 * i ).with_data( "x" ).with_timestamp( 2 + i ) );
+      }
+      test.execute( ExpectSACKBlocks { { { Wrap32 { isn + 8 }, Wrap32 { isn + 9 } },
+                                         { Wrap32 { isn + 6 }, Wrap32 { isn + 7 } },
+                                         { Wrap32 { isn + 4 }, Wrap32 { isn + 5 } } } } );
+    }
+
+    {
+      // the timestamp option survives a round trip through the TCP header, alongside SACK blocks
+      TCPSegment seg;
+      seg.message.sender.seqno = Wrap32 { 1000 };
+      seg.message.sender.payload = "hello";
+      seg.message.sender.timestamp = 0xdeadbeef;
+      seg.message.receiver.ackno = Wrap32 { 5000 };
+      seg.message.receiver.timestamp_echo = 12345;
+      seg.message.receiver.window_size = 4000;
+      seg.message.receiver.sack_blocks = { { Wrap32 { 6000 }, Wrap32 { 7000 } },
+                                           { Wrap32 { 8000 }, Wrap32 { 9000 } },
+                                           { Wrap32 { 10000 }, Wrap32 { 11000 } },
+                                           { Wrap32 { 12000 }, Wrap32 { 13000 } } };
+      seg.compute_checksum( 0 );
+
+      TCPSegment parsed;
+      if ( not parse( parsed, serialize( seg ), 0 ) ) {
+        throw runtime_error( "could not parse a serialized segment carrying the timestamp option" );
+      }
+      if ( parsed.message.sender.timestamp != optional<uint32_t> { 0xdeadbeef }
+           or parsed.message.receiver.timestamp_echo != optional<uint32_t> { 12345 }
+           or parsed.message.sender.payload != "hello" ) {
+        throw runtime_error( "timestamp option did not survive the round trip" );
+      }
+      if ( parsed.message.receiver.sack_blocks.size() != 3 ) {
+        throw runtime_error( "expected the timestamp option to leave room for three SACK blocks" );
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
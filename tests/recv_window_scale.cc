@@ -0,0 +1,70 @@
+#include "parser.hh"
+#include "random.hh"
+#include "receiver_test_harness.hh"
+#include "tcp_segment.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "Scaled window advertises a 1 MiB capacity", 1 << 20 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_window_scale( 7 ) );
+      test.execute( ExpectWindow { ( 1 << 20 ) >> 5 } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4096, 'x' ) ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 4097 } } );
+      test.execute( ExpectWindow { ( ( 1 << 20 ) - 4096 ) >> 5 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "No scaling unless the peer's SYN offers it", 1 << 20 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectWindow { UINT16_MAX } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "Small capacities need no shift", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_window_scale( 3 ) );
+      test.execute( ExpectWindow { 4000 } );
+    }
+
+    {
+      // the window scale option survives a round trip through the TCP header
+      TCPSegment seg;
+      seg.message.sender.seqno = Wrap32 { 1000 };
+      seg.message.sender.SYN = true;
+      seg.message.sender.mss = 1460;
+      seg.message.sender.window_scale = 9;
+      seg.message.receiver.window_size = 12345;
+      seg.compute_checksum( 0 );
+
+      TCPSegment parsed;
+      if ( not parse( parsed, serialize( seg ), 0 ) ) {
+        throw runtime_error( "could not parse a serialized SYN carrying a window scale option" );
+      }
+      if ( parsed.message.sender.window_scale != optional<uint8_t> { 9 }
+           or parsed.message.sender.mss != optional<uint16_t> { 1460 }
+           or parsed.message.receiver.window_size != 12345 ) {
+        throw runtime_error( "window scale option did not survive the round trip" );
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "NewReno initial window limits the first flight", cfg };
+      test.execute( ExpectCongestionWindow { 4000 } );
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 4001 } );
+      test.execute( Push { string( 10000, 'x' ) } );
+      for ( int i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 4001 } );
+
+      // slow start: each ACK grows cwnd by at most one MSS
+      test.execute( AckReceived { Wrap32 { isn + 1 + 1000 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 5001 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 5001 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t rto = uniform_int_distribution<uint16_t> { 30, 10000 }( rd );
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "NewReno collapses to one segment on timeout", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 4001, 'x' ) } );
+      for ( int i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ) );
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectCongestionWindow { 1000 } );
+      test.execute( ExpectSlowStartThreshold { 2000 } );
+
+      // back in slow start until ssthresh, then one MSS per window of ACKed data
+      test.execute( AckReceived { Wrap32 { isn + 1 + 1000 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 2000 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 + 2000 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 2000 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 + 4001 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 3000 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "Receiver window still applies under NewReno", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1500 ) );
+      test.execute( Push { string( 4000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 500 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t rto = 10000;
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+      cfg.congestion_control = CongestionControlAlgorithm::Cubic;
+
+      TCPSenderTestHarness test { "CUBIC backs off by beta and regrows", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 4001 } );
+      test.execute( Push { string( 4001, 'x' ) } );
+      for ( int i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ) );
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectCongestionWindow { 1000 } );
+      test.execute( ExpectSlowStartThreshold { 2800 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 1 + 1000 } }.with_win( 60000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 + 2000 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 3000 } );
+
+      // congestion avoidance starts the cubic epoch, still below the pre-loss window
+      test.execute( AckReceived { Wrap32 { isn + 1 + 3000 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 3176 } );
+
+      // five seconds later the cubic has passed its plateau and growth is capped at 1.5x per window
+      test.execute( Tick { 5000 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 + 4001 } }.with_win( 60000 ) );
+      test.execute( ExpectCongestionWindow { 3676 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
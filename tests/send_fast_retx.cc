@@ -0,0 +1,197 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.dup_ack_threshold = 3;
+
+      TCPSenderTestHarness test { "Third duplicate ACK triggers fast retransmit", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 5000, 'x' ) } );
+      for ( uint32_t i = 0; i < 5; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectFastRetransmits { 1 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // a partial ACK retransmits the next hole right away
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 10000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectLossesRepairedWithoutRTO { 0 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 5001 } }.with_win( 10000 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( ExpectLossesRepairedWithoutRTO { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.dup_ack_threshold = 3;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "Fast recovery keeps the pipe full", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 8000, 'x' ) } );
+      for ( uint32_t i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ) );
+      test.execute( ExpectSeqnosInFlight { 4001 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectCongestionWindow { 2000 } );
+      test.execute( ExpectSlowStartThreshold { 2000 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 999 ).with_seqno( isn + 4002 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // each further duplicate ACK lets one more segment out
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 5001 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // the ACK covering everything outstanding at the loss ends recovery at ssthresh
+      test.execute( AckReceived { Wrap32 { isn + 4002 } }.with_win( 60000 ) );
+      test.execute( ExpectLossesRepairedWithoutRTO { 1 } );
+      test.execute( ExpectCongestionWindow { 2000 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ).with_seqno( isn + 6001 ) );
+      test.execute( ExpectSeqnosInFlight { 2000 } );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.dup_ack_threshold = 3;
+
+      TCPSenderTestHarness test { "Window updates are not duplicate ACKs", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 2000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 3000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 2001 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 3000 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectFastRetransmits { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.dup_ack_threshold = 3;
+
+      TCPSenderTestHarness test { "ACKs on data segments are not duplicate ACKs", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      for ( int i = 0; i < 4; ++i ) {
+        test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ).with_data_segment() );
+      }
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectFastRetransmits { 0 } );
+
+      // pure ACKs still count
+      for ( int i = 0; i < 3; ++i ) {
+        test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectFastRetransmits { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.dup_ack_threshold = 3;
+      cfg.persist_timer = true;
+
+      TCPSenderTestHarness test { "Stale ACKs are ignored", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+
+      // an ACK from before snd_una neither closes the window nor resets the duplicate count
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 0 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectPersisting { false } );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 10000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectFastRetransmits { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+
+      TCPSenderTestHarness test { "Fast retransmit is off by default", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 2000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      for ( int i = 0; i < 4; ++i ) {
+        test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      }
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectFastRetransmits { 0 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
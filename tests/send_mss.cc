@@ -0,0 +1,132 @@
+#include "parser.hh"
+#include "random.hh"
+#include "sender_test_harness.hh"
+#include "tcp_segment.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.mss = 1460;
+
+      TCPSenderTestHarness test { "Configured MSS sizes segments", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1460 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1460 ).with_seqno( isn + 1461 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 80 ).with_seqno( isn + 2921 ) );
+
+      // the peer's MSS option lowers it
+      test.execute( PeerMSS { 536 } );
+      test.execute( ExpectMSS { 536 } );
+      test.execute( Push { string( 1000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 536 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 464 ).with_seqno( isn + 3537 ) );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.mss = 1460;
+      cfg.pmtu_probing = true;
+
+      TCPSenderTestHarness test { "A successful PMTU probe raises the MSS", cfg };
+      test.execute( ExpectMSS { 1000 } );
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 5000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1230 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1231 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 2231 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 3231 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 770 ).with_seqno( isn + 4231 ) );
+      test.execute( AckReceived { Wrap32 { isn + 1231 } }.with_win( 60000 ) );
+      test.execute( ExpectMSS { 1230 } );
+
+      test.execute( Push { string( 2000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1345 ).with_seqno( isn + 5001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 655 ).with_seqno( isn + 6346 ) );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t rto = uniform_int_distribution<uint16_t> { 30, 10000 }( rd );
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+      cfg.mss = 1460;
+      cfg.pmtu_probing = true;
+
+      TCPSenderTestHarness test { "A lost PMTU probe is resent in MSS-sized pieces", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+
+      // one lost probe is not enough to call a size too big: it takes three in a row
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        const Wrap32 start = isn + 1 + 1230 * i;
+        test.execute( Push { string( 1230, 'x' ) } );
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1230 ).with_seqno( start ) );
+        test.execute( Tick { rto } );
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( start ) );
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 230 ).with_seqno( start + 1000 ) );
+        test.execute( ExpectNoSegment {} );
+        test.execute( AckReceived { start + 1230 }.with_win( 60000 ) );
+        test.execute( ExpectMSS { 1000 } );
+      }
+
+      // the search continues below the size that failed
+      test.execute( Push { string( 2000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1115 ).with_seqno( isn + 3691 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 885 ).with_seqno( isn + 4806 ) );
+      test.execute( AckReceived { Wrap32 { isn + 5691 } }.with_win( 60000 ) );
+      test.execute( ExpectMSS { 1115 } );
+
+      // ten minutes later the search starts over from the negotiated MSS
+      test.execute( Tick { 600000 } );
+      test.execute( Push { string( 2000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1288 ).with_seqno( isn + 5691 ) );
+    }
+
+    {
+      // the MSS option survives a round trip through the TCP header
+      TCPSegment seg;
+      seg.message.sender.seqno = Wrap32 { 1000 };
+      seg.message.sender.SYN = true;
+      seg.message.sender.mss = 8960;
+      seg.compute_checksum( 0 );
+
+      TCPSegment parsed;
+      if ( not parse( parsed, serialize( seg ), 0 ) ) {
+        throw runtime_error( "could not parse a serialized SYN carrying an MSS option" );
+      }
+      if ( parsed.message.sender.mss != optional<uint16_t> { 8960 } or not parsed.message.sender.SYN ) {
+        throw runtime_error( "MSS option did not survive the round trip" );
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
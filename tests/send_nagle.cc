@@ -0,0 +1,94 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.nagle = true;
+
+      TCPSenderTestHarness test { "Nagle coalesces small writes while data is in flight", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { "a" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+      test.execute( Push { "b" } );
+      test.execute( Push { "c" } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { Wrap32 { isn + 2 } }.with_win( 60000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "bc" ).with_seqno( isn + 2 ) );
+
+      // full-sized segments are never held; the tail is
+      test.execute( Push { string( 1500, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 4 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // closing the stream sends what is left
+      test.execute( Close {} );
+      test.execute( ExpectMessage {}.with_payload_size( 500 ).with_fin( true ).with_seqno( isn + 1004 ) );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.nagle = true;
+
+      TCPSenderTestHarness test { "Flush overrides Nagle", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { "a" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+      test.execute( Push { "bc" } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Flush {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "bc" ).with_seqno( isn + 2 ) );
+      test.execute( Push { "d" } );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+
+      TCPSenderTestHarness test { "Cork holds partial segments even with nothing in flight", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Cork {} );
+      test.execute( Push { "abc" } );
+      test.execute( Push { "def" } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Push { string( 1000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Uncork {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 6 ).with_seqno( isn + 1001 ) );
+      test.execute( Push { "g" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "g" ).with_seqno( isn + 1007 ) );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.persist_timer = true;
+      const uint64_t rto = cfg.rt_timeout;
+
+      TCPSenderTestHarness test { "Persist timer probes a zero window with exponential backoff", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 0 ) );
+      test.execute( Push { "abc" } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectPersisting { true } );
+
+      // probes at RTO, then 2*RTO, then 4*RTO; none of them counts as a retransmission timeout
+      uint64_t interval = rto;
+      for ( unsigned int i = 1; i <= 3; ++i ) {
+        test.execute( Tick { interval - 1 } );
+        test.execute( ExpectNoSegment {} );
+        test.execute( Tick { 1 } );
+        test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+        test.execute( ExpectWindowProbes { i } );
+        test.execute( ExpectConsecutiveRetransmissions { 0 } );
+        test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 0 ) );
+        test.execute( ExpectNoSegment {} );
+        interval *= 2;
+      }
+
+      // the receiver took the probe byte but its window is still closed: the next probe is new data
+      test.execute( AckReceived { Wrap32 { isn + 2 } }.with_win( 0 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( Tick { interval - 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+
+      // the window reopens: leave persist mode, send the rest, and hand the probe back to the RTO
+      test.execute( AckReceived { Wrap32 { isn + 2 } }.with_win( 10 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "c" ).with_seqno( isn + 3 ) );
+      test.execute( ExpectPersisting { false } );
+      test.execute( Tick { rto - 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+      test.execute( ExpectConsecutiveRetransmissions { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.persist_timer = true;
+      const uint64_t rto = cfg.rt_timeout;
+
+      TCPSenderTestHarness test { "A window that closes on outstanding data suspends the RTO", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 3000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 0 ) );
+      test.execute( ExpectPersisting { true } );
+
+      // the oldest unacknowledged segment doubles as the probe
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectWindowProbes { 1 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+      test.execute( Tick { 2 * rto - 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 3000 ) );
+      test.execute( ExpectPersisting { false } );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( Tick { 10 * rto } );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.persist_timer = true;
+      cfg.nagle = true;
+      const uint64_t rto = cfg.rt_timeout;
+
+      TCPSenderTestHarness test { "A corked sender still sends its window probes", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 0 ) );
+      test.execute( Cork {} );
+      test.execute( Push { "abc" } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectPersisting { true } );
+
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectWindowProbes { 1 } );
+      test.execute( AckReceived { Wrap32 { isn + 2 } }.with_win( 0 ) );
+      test.execute( Tick { 2 * rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+      test.execute( ExpectWindowProbes { 2 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.persist_timer = true;
+      cfg.pacing = true;
+      cfg.pacing_rate_cap = 100; // 0.1 bytes per ms
+      const uint64_t rto = cfg.rt_timeout;
+
+      TCPSenderTestHarness test { "Pacing does not hold back a window probe", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 1500, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 500 ) );
+      test.execute( Push { string( 1500, 'y' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // the pacing bucket is still in debt when the persist timer fires
+      test.execute( AckReceived { Wrap32 { isn + 2501 } }.with_win( 0 ) );
+      test.execute( ExpectPersisting { true } );
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "y" ).with_seqno( isn + 2501 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectWindowProbes { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const size_t rto = uniform_int_distribution<uint16_t> { 30, 10000 }( rd );
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+
+      TCPSenderTestHarness test { "Without a persist timer, RTO backoff resumes once the window reopens", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 0 ) );
+      test.execute( Push { "ab" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "a" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 2 } }.with_win( 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+      test.execute( Tick { rto } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+      test.execute( Tick { 2 * rto - 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "b" ).with_seqno( isn + 2 ) );
+      test.execute( ExpectConsecutiveRetransmissions { 2 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rack_tlp = true;
+
+      TCPSenderTestHarness test { "Tail loss probe resends the last segment after two RTTs", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( Tick { 19 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 2001 ) );
+      test.execute( ExpectTailLossProbes { 1 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+
+      // the probe's ACK covers everything: recovered in one round trip, no RTO
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 60000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( Tick { 2000 } );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rack_tlp = true;
+      cfg.nagle = true;
+
+      TCPSenderTestHarness test { "Tail loss probe sends new data when the window allows", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 2500, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectNoSegment {} ); // Nagle holds the last 500 bytes while data is in flight
+
+      test.execute( Tick { 20 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 500 ).with_seqno( isn + 2001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectTailLossProbes { 1 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 2501 } }.with_win( 60000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rack_tlp = true;
+
+      TCPSenderTestHarness test { "Tail loss probe resends the last segment when the window is full", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 2000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // no room for new data: the probe is the last segment again
+      test.execute( Tick { 20 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectTailLossProbes { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rack_tlp = true;
+
+      TCPSenderTestHarness test { "RACK marks a hole lost once a later segment is SACKed", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 60000 ).with_sack( isn + 2001, isn + 3001 ) );
+
+      // the middle segment may only be reordered: wait a quarter of the min RTT before calling it lost
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectLossRetransmits { 1 } );
+      test.execute( ExpectNoSegment {} );
+
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 60000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( ExpectLossesRepairedWithoutRTO { 1 } );
+      test.execute( ExpectTailLossProbes { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rack_tlp = true;
+
+      TCPSenderTestHarness test { "RACK uses SACK blocks on duplicate ACKs", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      for ( uint32_t i = 0; i < 3; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ).with_sack( isn + 1001, isn + 3001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 2 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectLossRetransmits { 1 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t rto = uniform_int_distribution<uint16_t> { 30, 10000 }( rd );
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+
+      TCPSenderTestHarness test { "Many small segments wrap around the retransmission ring", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+
+      uint32_t sent = 0;
+      uint32_t acked = 0;
+      for ( uint32_t round = 0; round < 20; ++round ) {
+        const uint32_t burst = uniform_int_distribution<uint32_t> { 1, 40 }( rd );
+        for ( uint32_t i = 0; i < burst; ++i ) {
+          const string data = to_string( sent % 10 );
+          test.execute( Push { data } );
+          test.execute( ExpectMessage {}.with_no_flags().with_data( data ).with_seqno( isn + 1 + sent ) );
+          ++sent;
+        }
+        test.execute( ExpectSeqnosInFlight { sent - acked } );
+
+        // the oldest outstanding segment is the one retransmitted
+        test.execute( Tick { rto } );
+        test.execute(
+          ExpectMessage {}.with_no_flags().with_data( to_string( acked % 10 ) ).with_seqno( isn + 1 + acked ) );
+
+        acked += uniform_int_distribution<uint32_t> { 1, sent - acked }( rd );
+        test.execute( AckReceived { Wrap32 { isn + 1 + acked } }.with_win( 60000 ) );
+        test.execute( ExpectSeqnosInFlight { sent - acked } );
+        test.execute( ExpectNoSegment {} );
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
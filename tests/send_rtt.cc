@@ -0,0 +1,105 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+      cfg.min_rto_ms = 10;
+
+      TCPSenderTestHarness test { "RTO follows measured RTTs", cfg };
+      test.execute( ExpectRTO { 1000 } );
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( Tick { 50 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ) );
+      test.execute( ExpectRTO { 150 } ); // SRTT = 50, RTTVAR = 25
+
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( Tick { 149 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectRTO { 300 } );
+
+      // Karn's algorithm: the ACK of a retransmitted segment is not an RTT sample
+      test.execute( Tick { 10 } );
+      test.execute( AckReceived { Wrap32 { isn + 4 } }.with_win( 1000 ) );
+      test.execute( ExpectRTO { 300 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+
+      test.execute( Push { "def" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "def" ).with_seqno( isn + 4 ) );
+      test.execute( Tick { 30 } );
+      test.execute( AckReceived { Wrap32 { isn + 7 } }.with_win( 1000 ) );
+      test.execute( ExpectRTO { 143 } ); // SRTT = 47.5, RTTVAR = 23.75
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+      cfg.min_rto_ms = 200;
+      cfg.max_rto_ms = 700;
+
+      TCPSenderTestHarness test { "Adaptive RTO is clamped", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( Tick { 5 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ) );
+      test.execute( ExpectRTO { 200 } );
+
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( Tick { 200 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectRTO { 400 } );
+      test.execute( Tick { 400 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectRTO { 700 } );
+      test.execute( Tick { 700 } );
+      test.execute( ExpectMessage {}.with_no_flags().with_data( "abc" ).with_seqno( isn + 1 ) );
+      test.execute( ExpectRTO { 700 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t rto = uniform_int_distribution<uint16_t> { 30, 10000 }( rd );
+      cfg.isn = isn;
+      cfg.rt_timeout = rto;
+
+      TCPSenderTestHarness test { "Fixed RTO is unchanged by RTT samples", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_no_flags().with_syn( true ).with_payload_size( 0 ).with_seqno( isn ) );
+      test.execute( Tick { 5 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ) );
+      test.execute( ExpectRTO { rto } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.sack_recovery = true;
+
+      TCPSenderTestHarness test { "A hole with three SACKed segments above it is lost", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 5000, 'x' ) } );
+      for ( uint32_t i = 0; i < 5; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 60000 ).with_sack( isn + 2001, isn + 5001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectLossRetransmits { 1 } );
+      test.execute( ExpectSeqnosInFlight { 4000 } );
+      test.execute( ExpectBytesInPipe { 1000 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 5001 } }.with_win( 60000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( ExpectBytesInPipe { 0 } );
+      test.execute( ExpectLossesRepairedWithoutRTO { 1 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.sack_recovery = true;
+
+      TCPSenderTestHarness test { "Two SACKed segments may just be reordering", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 4000, 'x' ) } );
+      for ( uint32_t i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 60000 ).with_sack( isn + 2001, isn + 4001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 3000 } );
+      test.execute( ExpectBytesInPipe { 1000 } );
+      test.execute( ExpectLossRetransmits { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.sack_recovery = true;
+
+      TCPSenderTestHarness test { "Every hole in the window is resent in one round trip", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 8000, 'x' ) } );
+      for ( uint32_t i = 0; i < 8; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }
+                      .with_win( 60000 )
+                      .with_sack( isn + 4001, isn + 8001 )
+                      .with_sack( isn + 2001, isn + 3001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectLossRetransmits { 2 } );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.sack_recovery = true;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "cwnd limits the pipe, not the outstanding bytes", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 4001, 'x' ) } );
+      for ( uint32_t i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1 ) );
+
+      // the first segment is lost; everything after it arrived
+      test.execute(
+        AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ).with_sack( isn + 1001, isn + 4002 ).without_push() );
+      test.execute( ExpectCongestionWindow { 2000 } );
+      test.execute( Push { string( 3000, 'y' ) } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 4002 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 5001 } );
+      test.execute( ExpectBytesInPipe { 2000 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.sack_recovery = true;
+
+      TCPSenderTestHarness test { "After an RTO every segment the peer has not SACKed is resent", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 4000, 'x' ) } );
+      for ( uint32_t i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ) );
+      }
+
+      // one SACKed segment is not enough to call the others lost
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ).with_sack( isn + 2001, isn + 3001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectBytesInPipe { 3000 } );
+
+      test.execute( Tick { cfg.rt_timeout } );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectMessage {}.with_no_flags().with_payload_size( 1000 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectLossRetransmits { 2 } );
+      test.execute( ExpectSeqnosInFlight { 4000 } );
+      test.execute( ExpectBytesInPipe { 3000 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 4001 } }.with_win( 60000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+      test.execute( ExpectBytesInPipe { 0 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+      cfg.min_rto_ms = 1;
+      cfg.timestamps = true;
+
+      TCPSenderTestHarness test { "Timestamp echoes give RTT samples even after retransmission", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ).with_timestamp( 0 ) );
+      test.execute( Tick { 50 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ).with_timestamp_echo( 0 ) );
+      test.execute( ExpectRTO { 150 } );
+
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_data( "abc" ).with_timestamp( 50 ) );
+      test.execute( Tick { 150 } );
+      test.execute( ExpectMessage {}.with_data( "abc" ).with_timestamp( 200 ) );
+      test.execute( ExpectRTO { 300 } );
+
+      // Karn's algorithm would ignore this ACK; the echo says which transmission it answers
+      test.execute( Tick { 20 } );
+      test.execute( AckReceived { Wrap32 { isn + 4 } }.with_win( 1000 ).with_timestamp_echo( 200 ) );
+      test.execute( ExpectRTO { 152 } );
+      test.execute( ExpectTimestampOnEmptyMessage { 220 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.isn = isn;
+      cfg.timestamps = true;
+
+      TCPSenderTestHarness test { "No timestamps unless the peer's SYN carried them", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_timestamp( 0 ) );
+      test.execute( PeerTimestamps { false } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 1000 ) );
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_data( "abc" ).with_timestamp( nullopt ) );
+      test.execute( ExpectTimestampOnEmptyMessage { nullopt } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -80,6 +80,90 @@ struct ExpectConsecutiveRetransmissions : public ExpectNumber<SenderAndOutput, u
   uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.consecutive_retransmissions(); }
 };
 
+struct ExpectCongestionWindow : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "congestion_window"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.congestion_window(); }
+};
+
+struct ExpectSlowStartThreshold : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "slow_start_threshold"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.slow_start_threshold(); }
+};
+
+struct ExpectRTO : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "current_RTO_ms"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.current_RTO_ms(); }
+};
+
+struct ExpectFastRetransmits : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "fast_retransmits"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.fast_retransmits(); }
+};
+
+struct ExpectLossesRepairedWithoutRTO : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "losses_repaired_without_rto"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.losses_repaired_without_rto(); }
+};
+
+struct ExpectLossRetransmits : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "loss_retransmits"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.loss_retransmits(); }
+};
+
+struct ExpectBytesInPipe : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "bytes_in_pipe"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.bytes_in_pipe(); }
+};
+
+struct ExpectTailLossProbes : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "tail_loss_probes"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.tail_loss_probes(); }
+};
+
+struct ExpectWindowProbes : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "window_probes"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.window_probes(); }
+};
+
+struct ExpectPersisting : public ExpectBool<SenderAndOutput>
+{
+  using ExpectBool::ExpectBool;
+  std::string name() const override { return "persisting"; }
+  bool value( SenderAndOutput& ss ) const override { return ss.sender.persisting(); }
+};
+
+struct ExpectMsUntilNextSend : public Expectation<SenderAndOutput>
+{
+  std::optional<uint64_t> ms_;
+
+  explicit ExpectMsUntilNextSend( std::optional<uint64_t> ms ) : ms_( ms ) {}
+  std::string description() const override { return "ms_until_next_send = " + to_string( ms_ ); }
+  void execute( SenderAndOutput& ss ) const override
+  {
+    if ( ss.sender.ms_until_next_send() != ms_ ) {
+      throw ExpectationViolation( "ms_until_next_send", ms_, ss.sender.ms_until_next_send() );
+    }
+  }
+};
+
 struct ExpectNoSegment : public Expectation<SenderAndOutput>
 {
   std::string description() const override { return "nothing to send"; }
@@ -141,6 +225,79 @@ struct Push : public Action<SenderAndOutput>
   }
 };
 
+struct Cork : public Action<SenderAndOutput>
+{
+  std::string description() const override { return "cork TCPSender"; }
+  void execute( SenderAndOutput& ss ) const override { ss.sender.cork(); }
+};
+
+struct Uncork : public Action<SenderAndOutput>
+{
+  std::string description() const override { return "uncork, then push TCPSender"; }
+  void execute( SenderAndOutput& ss ) const override
+  {
+    ss.sender.uncork();
+    ss.sender.push( ss.make_transmit() );
+  }
+};
+
+struct Flush : public Action<SenderAndOutput>
+{
+  std::string description() const override { return "flush, then push TCPSender"; }
+  void execute( SenderAndOutput& ss ) const override
+  {
+    ss.sender.flush();
+    ss.sender.push( ss.make_transmit() );
+  }
+};
+
+struct PeerMSS : public Action<SenderAndOutput>
+{
+  uint64_t mss_;
+
+  explicit PeerMSS( uint64_t mss ) : mss_( mss ) {}
+  std::string description() const override { return "peer advertises MSS " + std::to_string( mss_ ); }
+  void execute( SenderAndOutput& ss ) const override { ss.sender.set_peer_mss( mss_ ); }
+};
+
+struct PeerWindowScale : public Action<SenderAndOutput>
+{
+  uint8_t shift_;
+
+  explicit PeerWindowScale( uint8_t shift ) : shift_( shift ) {}
+  std::string description() const override { return "peer window scale " + std::to_string( shift_ ); }
+  void execute( SenderAndOutput& ss ) const override { ss.sender.set_peer_window_scale( shift_ ); }
+};
+
+struct PeerTimestamps : public Action<SenderAndOutput>
+{
+  bool enabled_;
+
+  explicit PeerTimestamps( bool enabled ) : enabled_( enabled ) {}
+  std::string description() const override
+  {
+    return std::string { "peer's SYN " } + ( enabled_ ? "carried" : "did not carry" ) + " timestamps";
+  }
+  void execute( SenderAndOutput& ss ) const override { ss.sender.set_peer_timestamps( enabled_ ); }
+};
+
+struct ExpectTimestampOnEmptyMessage : public ExpectNumber<SenderAndOutput, std::optional<uint32_t>>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "make_empty_message().timestamp"; }
+  std::optional<uint32_t> value( SenderAndOutput& ss ) const override
+  {
+    return ss.sender.make_empty_message().timestamp;
+  }
+};
+
+struct ExpectMSS : public ExpectNumber<SenderAndOutput, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "mss"; }
+  uint64_t value( SenderAndOutput& ss ) const override { return ss.sender.mss(); }
+};
+
 struct Tick : public Action<SenderAndOutput>
 {
   uint64_t ms_;
@@ -187,12 +344,23 @@ struct Receive : public Action<SenderAndOutput>
 {
   TCPReceiverMessage msg_;
   bool push_ = true;
+  bool pure_ack_ = true;
 
   explicit Receive( TCPReceiverMessage msg ) : msg_( msg ) {}
   std::string description() const override
   {
     std::ostringstream desc;
-    desc << "receive(ack=" << to_string( msg_.ackno ) << ", win=" << msg_.window_size << ")";
+    desc << "receive(ack=" << to_string( msg_.ackno ) << ", win=" << msg_.window_size;
+    if ( msg_.timestamp_echo.has_value() ) {
+      desc << ", TSecr=" << msg_.timestamp_echo.value();
+    }
+    for ( const auto& block : msg_.sack_blocks ) {
+      desc << ", SACK=[" << block.left << ", " << block.right << ")";
+    }
+    if ( not pure_ack_ ) {
+      desc << ", on a data segment";
+    }
+    desc << ")";
     if ( push_ ) {
       desc << ", then push stream to TCPSender";
     }
@@ -205,14 +373,33 @@ struct Receive : public Action<SenderAndOutput>
     return *this;
   }
 
+  // the ACK arrives on a segment that also carries data
+  Receive& with_data_segment()
+  {
+    pure_ack_ = false;
+    return *this;
+  }
+
   void execute( SenderAndOutput& ss ) const override
   {
-    ss.sender.receive( msg_ );
+    ss.sender.receive( msg_, pure_ack_ );
     if ( push_ ) {
       ss.sender.push( ss.make_transmit() );
     }
   }
 
+  Receive& with_timestamp_echo( uint32_t tsecr )
+  {
+    msg_.timestamp_echo = tsecr;
+    return *this;
+  }
+
+  Receive& with_sack( Wrap32 left, Wrap32 right )
+  {
+    msg_.sack_blocks.push_back( { left, right } );
+    return *this;
+  }
+
   Receive& without_push()
   {
     push_ = false;
@@ -238,6 +425,7 @@ struct ExpectMessage : public Expectation<SenderAndOutput>
   std::optional<Wrap32> seqno {};
   std::optional<std::string> data {};
   std::optional<size_t> payload_size {};
+  std::optional<std::optional<uint32_t>> timestamp {};
 
   ExpectMessage& with_syn( bool syn_ )
   {
@@ -277,6 +465,12 @@ struct ExpectMessage : public Expectation<SenderAndOutput>
     return *this;
   }
 
+  ExpectMessage& with_timestamp( std::optional<uint32_t> timestamp_ )
+  {
+    timestamp = timestamp_;
+    return *this;
+  }
+
   ExpectMessage& with_data( std::string data_ )
   {
     data = std::move( data_ );
@@ -308,6 +502,9 @@ struct ExpectMessage : public Expectation<SenderAndOutput>
     if ( rst.has_value() ) {
       o << ( rst.value() ? " +RST" : " (no RST)" );
     }
+    if ( timestamp.has_value() ) {
+      o << " TSval=" << to_string( timestamp.value() );
+    }
     return o.str();
   }
 
@@ -337,10 +534,13 @@ struct ExpectMessage : public Expectation<SenderAndOutput>
     if ( seqno.has_value() and seg.seqno != seqno.value() ) {
       throw ExpectationViolation( "sequence number", seqno.value(), seg.seqno );
     }
+    if ( timestamp.has_value() and seg.timestamp != timestamp.value() ) {
+      throw ExpectationViolation( "timestamp", timestamp.value(), seg.timestamp );
+    }
     if ( payload_size.has_value() and seg.payload.size() != payload_size.value() ) {
       throw ExpectationViolation( "payload_size", payload_size.value(), seg.payload.size() );
     }
-    if ( seg.payload.size() > TCPConfig::MAX_PAYLOAD_SIZE ) {
+    if ( seg.payload.size() > ss.sender.max_mss() ) {
       throw ExpectationViolation( "payload has length (" + std::to_string( seg.payload.size() )
                                   + ") greater than the maximum" );
     }
@@ -359,6 +559,6 @@ public:
   TCPSenderTestHarness( std::string name, TCPConfig config )
     : TestHarness( move( name ),
                    "initial_RTO_ms=" + to_string( config.rt_timeout ),
-                   { TCPSender { ByteStream { config.send_capacity }, config.isn, config.rt_timeout } } )
+                   { TCPSender { ByteStream { config.send_capacity }, config } } )
   {}
 };
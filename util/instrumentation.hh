@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Opt-in counters for attributing memory churn (configure with -DMINNOW_INSTRUMENT=ON).
+// By default every update compiles to nothing and the stats structs stay zero.
+#ifdef MINNOW_INSTRUMENT
+inline constexpr bool kInstrumented = true;
+#else
+inline constexpr bool kInstrumented = false;
+#endif
+
+// Add `n` to an instrumentation counter, if instrumentation is compiled in
+inline void instrument_count( uint64_t& counter, uint64_t n = 1 )
+{
+  if constexpr ( kInstrumented ) {
+    counter += n;
+  }
+}
@@ -7,6 +7,7 @@
 
 #include <optional>
 #include <random>
+#include <span>
 #include <utility>
 
 //! An adapter class that adds random dropping behavior to an FD adapter
@@ -59,6 +60,24 @@ public:
     return _adapter.write( seg );
   }
 
+  //! \brief Write a burst to the underlying AdapterT instance, dropping each datagram independently
+  //! \param[in] segs are the packets to either write or drop; the survivors go down in contiguous runs
+  void write( std::span<const TCPMessage> segs )
+  {
+    size_t run_start = 0;
+    for ( size_t i = 0; i < segs.size(); ++i ) {
+      if ( _should_drop( true ) ) {
+        if ( i > run_start ) {
+          _adapter.write( segs.subspan( run_start, i - run_start ) );
+        }
+        run_start = i + 1;
+      }
+    }
+    if ( run_start < segs.size() ) {
+      _adapter.write( segs.subspan( run_start ) );
+    }
+  }
+
   //! \name
   //! Passthrough functions to the underlying AdapterT instance
 
@@ -7,6 +7,7 @@
 #include <net/if.h>
 #include <stdexcept>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 using namespace std;
@@ -151,6 +152,39 @@ void DatagramSocket::send( const string_view payload )
   register_write();
 }
 
+void DatagramSocket::send_batch( const vector<vector<string>>& datagrams )
+{
+  size_t buffer_count = 0;
+  for ( const auto& datagram : datagrams ) {
+    buffer_count += datagram.size();
+  }
+
+  // one message header per datagram, pointing into one shared array of iovecs
+  vector<iovec> iovecs;
+  iovecs.reserve( buffer_count );
+  vector<mmsghdr> headers( datagrams.size() );
+  for ( size_t i = 0; i < datagrams.size(); ++i ) {
+    headers[i].msg_hdr.msg_iov = iovecs.data() + iovecs.size();
+    headers[i].msg_hdr.msg_iovlen = datagrams[i].size();
+    for ( const auto& buffer : datagrams[i] ) {
+      iovecs.push_back( { const_cast<char*>( buffer.data() ), buffer.size() } ); // NOLINT(*-const-cast)
+    }
+  }
+
+  // sendmmsg can stop short; carry on from the first datagram it didn't send
+  size_t sent = 0;
+  while ( sent < headers.size() ) {
+    const int count = CheckSystemCall(
+      "sendmmsg",
+      ::sendmmsg( fd_num(), headers.data() + sent, static_cast<unsigned int>( headers.size() - sent ), 0 ) );
+    register_write();
+    if ( count == 0 ) {
+      return; // a full non-blocking socket drops the rest, as send() would
+    }
+    sent += count;
+  }
+}
+
 // mark the socket as listening for incoming connections
 //! \param[in] backlog is the number of waiting connections to queue (see [listen(2)](\ref man2::listen))
 void TCPSocket::listen( const int backlog )
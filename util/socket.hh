@@ -5,7 +5,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <string>
 #include <sys/socket.h>
+#include <vector>
 
 //! \brief Base class for network sockets (TCP, UDP, etc.)
 //! \details Socket is generally used via a subclass. See TCPSocket and UDPSocket for usage examples.
@@ -71,6 +73,10 @@ public:
 
   //! Send datagram to the socket's connected address (must call connect() first)
   void send( std::string_view payload );
+
+  //! Send several datagrams, each gathered from its buffers, to the connected address with as few
+  //! [sendmmsg(2)](\ref man2::sendmmsg) calls as the kernel allows
+  void send_batch( const std::vector<std::vector<std::string>>& datagrams );
 };
 
 //! A wrapper around [UDP sockets](\ref man7::udp)
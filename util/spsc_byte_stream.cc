@@ -0,0 +1,140 @@
+#include "spsc_byte_stream.hh"
+
+#include "exception.hh"
+
+#include <algorithm>
+#include <bit>
+#include <sys/eventfd.h>
+
+using namespace std;
+
+namespace {
+
+FileDescriptor make_eventfd()
+{
+  return FileDescriptor { CheckSystemCall( "eventfd", ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC ) ) };
+}
+
+void signal_eventfd( FileDescriptor& fd )
+{
+  const uint64_t one = 1;
+  fd.write( string_view { reinterpret_cast<const char*>( &one ), sizeof( one ) } ); // NOLINT(*-reinterpret-cast)
+}
+
+void drain_eventfd( FileDescriptor& fd )
+{
+  string counter( sizeof( uint64_t ), 0 );
+  fd.read( counter ); // non-blocking: leaves `counter` empty if nothing was signalled
+}
+
+} // namespace
+
+SPSCByteStream::SPSCByteStream( uint64_t capacity )
+  : capacity_( capacity )
+  , buffer_( bit_ceil( max<uint64_t>( capacity, 1 ) ), 0 )
+  , data_available_( make_eventfd() )
+  , space_available_( make_eventfd() )
+{}
+
+uint64_t SPSCByteStream::push( string_view data )
+{
+  if ( closed_.load( memory_order_relaxed ) ) {
+    return 0;
+  }
+
+  const uint64_t pushed = pushed_.load( memory_order_relaxed );
+  data = data.substr( 0, min<uint64_t>( data.size(), available_capacity() ) );
+  if ( data.empty() ) {
+    return 0;
+  }
+
+  const uint64_t offset = pushed & ( buffer_.size() - 1 );
+  const uint64_t first_part = min<uint64_t>( data.size(), buffer_.size() - offset );
+  copy_n( data.begin(), first_part, buffer_.begin() + offset );
+  copy( data.begin() + first_part, data.end(), buffer_.begin() );
+
+  pushed_.store( pushed + data.size() );
+
+  // Only wake the consumer if it had drained everything (and so may be asleep).
+  // Both sides use sequentially consistent store-then-load, so one of them always sees the other.
+  if ( popped_.load() == pushed ) {
+    signal_eventfd( data_available_ );
+  }
+
+  return data.size();
+}
+
+void SPSCByteStream::close()
+{
+  closed_.store( true );
+  signal_eventfd( data_available_ );
+}
+
+uint64_t SPSCByteStream::available_capacity() const
+{
+  return capacity_ - ( pushed_.load( memory_order_relaxed ) - popped_.load() );
+}
+
+uint64_t SPSCByteStream::bytes_pushed() const
+{
+  return pushed_.load( memory_order_relaxed );
+}
+
+FileDescriptor& SPSCByteStream::space_available_fd()
+{
+  return space_available_;
+}
+
+void SPSCByteStream::clear_space_available()
+{
+  drain_eventfd( space_available_ );
+}
+
+string_view SPSCByteStream::peek() const
+{
+  const uint64_t popped = popped_.load( memory_order_relaxed );
+  const uint64_t buffered = pushed_.load() - popped;
+  const uint64_t offset = popped & ( buffer_.size() - 1 );
+  return { buffer_.data() + offset, min<uint64_t>( buffered, buffer_.size() - offset ) };
+}
+
+void SPSCByteStream::pop( uint64_t len )
+{
+  const uint64_t popped = popped_.load( memory_order_relaxed );
+  len = min( len, bytes_buffered() );
+  if ( len == 0 ) {
+    return;
+  }
+
+  popped_.store( popped + len );
+
+  // Only wake the producer if the stream was full (and so the producer may be asleep).
+  if ( pushed_.load() - popped == capacity_ ) {
+    signal_eventfd( space_available_ );
+  }
+}
+
+bool SPSCByteStream::is_finished() const
+{
+  return closed_.load() and bytes_buffered() == 0;
+}
+
+uint64_t SPSCByteStream::bytes_buffered() const
+{
+  return pushed_.load() - popped_.load( memory_order_relaxed );
+}
+
+uint64_t SPSCByteStream::bytes_popped() const
+{
+  return popped_.load( memory_order_relaxed );
+}
+
+FileDescriptor& SPSCByteStream::data_available_fd()
+{
+  return data_available_;
+}
+
+void SPSCByteStream::clear_data_available()
+{
+  drain_eventfd( data_available_ );
+}
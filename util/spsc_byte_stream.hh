@@ -0,0 +1,53 @@
+#pragma once
+
+#include "file_descriptor.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//! \brief A ByteStream flavour safe for one producer thread and one consumer thread
+//! \details The bytes live in a fixed power-of-two ring buffer indexed by two atomic
+//! counters, so handing bytes across threads is a memcpy plus an atomic store. Each
+//! side gets an eventfd that becomes readable when the other side makes progress, so
+//! either thread can sleep in an EventLoop until there is something to do.
+//!
+//! TCPMinnowSocket uses a pair of these in place of a socketpair between its owner and its TCP thread.
+class SPSCByteStream
+{
+public:
+  explicit SPSCByteStream( uint64_t capacity );
+
+  //! \name Producer interface
+  //!@{
+  uint64_t push( std::string_view data ); //!< Push as much of `data` as fits; returns bytes accepted
+  void close();                           //!< Signal that nothing more will be pushed
+  uint64_t available_capacity() const;    //!< How many bytes can be pushed right now?
+  uint64_t bytes_pushed() const;          //!< Total number of bytes cumulatively pushed
+  FileDescriptor& space_available_fd();   //!< Readable once the consumer has popped bytes
+  void clear_space_available();           //!< Drain the space-available eventfd before sleeping on it
+  //!@}
+
+  //! \name Consumer interface
+  //!@{
+  std::string_view peek() const;       //!< Peek at the next contiguous run of buffered bytes
+  void pop( uint64_t len );            //!< Remove `len` bytes from the buffer
+  bool is_finished() const;            //!< Is the stream closed and fully popped?
+  uint64_t bytes_buffered() const;     //!< Number of bytes pushed and not yet popped
+  uint64_t bytes_popped() const;       //!< Total number of bytes cumulatively popped
+  FileDescriptor& data_available_fd(); //!< Readable once the producer has pushed bytes or closed
+  void clear_data_available();         //!< Drain the data-available eventfd before sleeping on it
+  //!@}
+
+private:
+  uint64_t capacity_;
+  std::string buffer_; // fixed at bit_ceil(capacity_), so it never moves under the other thread
+
+  std::atomic<uint64_t> pushed_ { 0 }; // written only by the producer
+  std::atomic<uint64_t> popped_ { 0 }; // written only by the consumer
+  std::atomic_bool closed_ { false };
+
+  FileDescriptor data_available_;
+  FileDescriptor space_available_;
+};
@@ -7,6 +7,14 @@
 #include <cstdint>
 #include <optional>
 
+//! Congestion-control algorithms a TCPSender can run
+enum class CongestionControlAlgorithm
+{
+  None,    //!< Send as much as the receiver's window allows
+  NewReno, //!< RFC 5681 slow start and congestion avoidance, RFC 6582 recovery
+  Cubic,   //!< RFC 9438 CUBIC window growth
+};
+
 //! Config for TCP sender and receiver
 class TCPConfig
 {
@@ -20,6 +28,26 @@ public:
   size_t recv_capacity = DEFAULT_CAPACITY; //!< Receive capacity, in bytes
   size_t send_capacity = DEFAULT_CAPACITY; //!< Sender capacity, in bytes
   Wrap32 isn { 137 };                      //!< Default initial sequence number
+  uint64_t max_held_ranges = 0;            //!< Cap on out-of-order ranges the Reassembler holds (0 = no limit)
+
+  //! Sender's cwnd policy
+  CongestionControlAlgorithm congestion_control = CongestionControlAlgorithm::None;
+
+  bool adaptive_rto = false;         //!< Derive the RTO from measured RTTs (RFC 6298)
+  uint64_t min_rto_ms = 200;         //!< Lower clamp on the adaptive RTO
+  uint64_t max_rto_ms = 60000;       //!< Upper clamp on the adaptive RTO and its backoff
+  uint64_t dup_ack_threshold = 0;    //!< Dup ACKs that trigger fast retransmit (0 = off, RFC 5681 uses 3)
+  bool pacing = false;               //!< Spread new segments at a rate derived from cwnd/SRTT
+  uint64_t pacing_rate_cap = 0;      //!< Upper bound on the pacing rate, in bytes/s (0 = no cap)
+  bool nagle = false;                //!< Hold small segments while data is in flight (Nagle)
+  uint16_t mss = MAX_PAYLOAD_SIZE;   //!< Largest payload sent or accepted; advertised in the SYN
+  bool pmtu_probing = false;         //!< Start at MAX_PAYLOAD_SIZE, probe up toward the negotiated MSS
+  bool timestamps = false;           //!< Offer timestamps (RFC 7323): RTT samples from echoes, PAWS
+  uint64_t delayed_ack_ms = 0;       //!< Hold an ACK for in-order data this long (0 = ACK every segment)
+  uint64_t delayed_ack_segments = 2; //!< While delaying, ACK every this many full-sized segments
+  bool rack_tlp = false;             //!< Time-based loss detection and tail loss probes (RFC 8985)
+  bool sack_recovery = false;        //!< Resend every hole the peer's SACK blocks reveal (RFC 6675)
+  bool persist_timer = false;        //!< Probe a zero window on a backed-off timer instead of the RTO
 };
 
 //! Config for classes derived from FdAdapter
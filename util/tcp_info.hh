@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+//! A snapshot of one connection's counters and state, in the spirit of Linux's `struct tcp_info`
+struct TCPInfo
+{
+  //! \name Sender
+  //!@{
+  uint64_t segments_sent {};          //!< Segments transmitted, including retransmissions and pure ACKs
+  uint64_t bytes_sent {};             //!< Payload bytes transmitted, including retransmissions
+  uint64_t segments_retransmitted {}; //!< Segments transmitted more than once (any cause)
+  uint64_t bytes_retransmitted {};    //!< Payload bytes in those segments
+  uint64_t timeouts {};               //!< Times the retransmission timer fired
+  uint64_t fast_retransmits {};       //!< Recoveries started by duplicate ACKs
+  uint64_t loss_retransmits {};       //!< Segments resent because RACK or the SACK scoreboard marked them lost
+  uint64_t tail_loss_probes {};       //!< Probes sent when the ACK clock stopped
+  uint64_t window_probes {};          //!< Probes sent by the persist timer while the peer's window was zero
+  uint64_t bytes_in_flight {};        //!< Outstanding sequence numbers
+  uint64_t bytes_in_pipe {};          //!< Outstanding, minus SACKed or lost (what cwnd limits)
+  uint64_t cwnd {};                   //!< Congestion window, in sequence numbers
+  uint64_t ssthresh {};               //!< Slow-start threshold, in sequence numbers
+  uint64_t mss {};                    //!< Current segment size
+  uint64_t rto_ms {};                 //!< Current retransmission timeout, including backoff
+  double srtt_ms {};                  //!< Smoothed RTT (0 until the first sample)
+  double rttvar_ms {};                //!< RTT variation (0 until the first sample)
+  //!@}
+
+  //! \name Receiver
+  //!@{
+  uint64_t segments_received {};     //!< Segments handed to the TCPPeer
+  uint64_t bytes_received {};        //!< Payload bytes in those segments, duplicates included
+  uint64_t out_of_order_segments {}; //!< Data segments that did not start at the ackno
+  uint64_t paws_rejected {};         //!< Segments dropped for carrying an old timestamp
+  uint64_t reassembler_pending {};   //!< Bytes held by the Reassembler beyond the ackno
+  uint64_t recv_window_zero_ms {};   //!< Time our receive window spent closed
+  //!@}
+};
+
+//! \brief Publishes TCPInfo snapshots from one thread to any number of readers without a lock
+//! \details A sequence lock: the writer bumps the sequence to odd, stores the snapshot word by word,
+//! and bumps it back to even; readers retry if the sequence changed (or was odd) while they copied.
+//! The writer never waits, so the TCP thread can publish after every event.
+class TCPInfoSnapshot
+{
+  static_assert( std::is_trivially_copyable_v<TCPInfo> and sizeof( TCPInfo ) % sizeof( uint64_t ) == 0 );
+  static constexpr size_t WORDS = sizeof( TCPInfo ) / sizeof( uint64_t );
+
+  std::atomic<uint64_t> sequence_ {};
+  std::array<std::atomic<uint64_t>, WORDS> words_ {};
+
+public:
+  //! Replace the snapshot (single writer)
+  void publish( const TCPInfo& info )
+  {
+    const auto raw = std::bit_cast<std::array<uint64_t, WORDS>>( info );
+
+    const uint64_t seq = sequence_.load( std::memory_order_relaxed );
+    sequence_.store( seq + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    for ( size_t i = 0; i < WORDS; ++i ) {
+      words_[i].store( raw[i], std::memory_order_relaxed );
+    }
+    sequence_.store( seq + 2, std::memory_order_release );
+  }
+
+  //! Read the latest complete snapshot
+  TCPInfo load() const
+  {
+    std::array<uint64_t, WORDS> raw {};
+    while ( true ) {
+      const uint64_t before = sequence_.load( std::memory_order_acquire );
+      for ( size_t i = 0; i < WORDS; ++i ) {
+        raw[i] = words_[i].load( std::memory_order_relaxed );
+      }
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if ( before % 2 == 0 and sequence_.load( std::memory_order_relaxed ) == before ) {
+        break;
+      }
+    }
+
+    return std::bit_cast<TCPInfo>( raw );
+  }
+};
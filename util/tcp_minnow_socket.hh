@@ -4,19 +4,24 @@
 #include "eventloop.hh"
 #include "file_descriptor.hh"
 #include "socket.hh"
+#include "spsc_byte_stream.hh"
 #include "tcp_config.hh"
+#include "tcp_info.hh"
 #include "tcp_peer.hh"
 #include "tuntap_adapter.hh"
 
 #include <atomic>
 #include <cstdint>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 //! Multithreaded wrapper around TCPPeer that approximates the Unix sockets API
 template<TCPDatagramAdapter AdaptT>
-class TCPMinnowSocket : public LocalStreamSocket
+class TCPMinnowSocket
 {
 public:
   //! Construct from the interface that the TCPPeer thread will use to read and write datagrams
@@ -47,24 +52,37 @@ public:
   //!@}
 
   //! \name
-  //! Some methods of the parent Socket wouldn't work as expected on the TCP socket, so delete them
+  //! Owner's side of the byte streams (never blocks, like a non-blocking socket)
 
   //!@{
-  void bind( const Address& address ) = delete;
-  Address local_address() const = delete;
-  void set_reuseaddr() = delete;
+  size_t write( std::string_view data ); //!< Queue as much of `data` as fits; returns bytes accepted
+  void read( std::string& buffer );      //!< Take every buffered inbound byte (empty if none)
+  bool eof() const;                      //!< Has the inbound stream finished and been fully read?
+  void close();                          //!< Signal that the owner will write nothing more
+
+  //! Outbound bytes, owner to TCP thread; poll its space_available_fd() when it is full
+  SPSCByteStream& outbound_stream() { return _outbound; }
+
+  //! Inbound bytes, TCP thread to owner; poll its data_available_fd() when it is empty
+  SPSCByteStream& inbound_stream() { return _inbound; }
   //!@}
 
   // Return peer address from underlying datagram adapter
   const Address& peer_address() const { return _datagram_adapter.config().destination; }
 
+  //! Connection statistics as of the TCP thread's last loop iteration (safe to call from any thread)
+  TCPInfo info() const { return _info.load(); }
+
 protected:
   //! Adapter to underlying datagram socket (e.g., UDP or IP)
   AdaptT _datagram_adapter;
 
 private:
-  //! Stream socket for reads and writes between owner and TCP thread
-  LocalStreamSocket _thread_data;
+  //! Bytes the owner writes, read by the TCP thread without a system call
+  SPSCByteStream _outbound { TCPConfig::DEFAULT_CAPACITY };
+
+  //! Bytes the TCP thread reassembled, read by the owner without a system call
+  SPSCByteStream _inbound { TCPConfig::DEFAULT_CAPACITY };
 
   //! Set up the TCPPeer and the event loop
   void _initialize_TCP( const TCPConfig& config );
@@ -72,9 +90,19 @@ private:
   //! TCP state machine
   std::optional<TCPPeer> _tcp {};
 
-  //! eventloop that handles all the events (new inbound datagram, new outbound bytes, new inbound bytes)
+  //! Latest TCPPeer::info(), published by the TCP thread and read without locking
+  TCPInfoSnapshot _info {};
+
+  //! Hands each burst of segments the TCPPeer produces to the datagram adapter in one call
+  const TCPPeer::BatchTransmitFunction _transmit {
+    [this]( std::span<const TCPMessage> batch ) { _datagram_adapter.write( batch ); } };
+
+  //! eventloop that handles all the events (new inbound datagram, new outbound bytes, room for inbound bytes)
   EventLoop _eventloop {};
 
+  //! Move bytes between the SPSCByteStreams and the TCPPeer's own streams
+  void _move_stream_bytes();
+
   //! Process events while specified condition is true
   void _tcp_loop( const std::function<bool()>& condition );
 
@@ -84,11 +112,10 @@ private:
   //! Handle to the TCPPeer thread; owner thread calls join() in the destructor
   std::thread _tcp_thread {};
 
-  //! Construct LocalStreamSocket fds from socket pair, initialize eventloop
-  TCPMinnowSocket( std::pair<FileDescriptor, FileDescriptor> data_socket_pair, AdaptT&& datagram_interface );
-
   std::atomic_bool _abort { false }; //!< Flag used by the owner to force the TCPPeer thread to shut down
 
+  std::atomic_bool _owner_done { false }; //!< Has the owner stopped reading the inbound stream?
+
   bool _inbound_shutdown { false }; //!< Has TCPMinnowSocket shut down the incoming data to the owner?
 
   bool _outbound_shutdown { false }; //!< Has the owner shut down the outbound data to the TCP connection?
@@ -98,6 +125,8 @@ private:
 
 using TCPOverIPv4MinnowSocket = TCPMinnowSocket<TCPOverIPv4OverTunFdAdapter>;
 using LossyTCPOverIPv4MinnowSocket = TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>>;
+using TCPOverIPv4OverUDPMinnowSocket = TCPMinnowSocket<TCPOverIPv4OverUDPFdAdapter>;
+using LossyTCPOverIPv4OverUDPMinnowSocket = TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4OverUDPFdAdapter>>;
 
 //! \class TCPMinnowSocket
 //! This class involves the simultaneous operation of two threads.
@@ -105,7 +134,8 @@ using LossyTCPOverIPv4MinnowSocket = TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4O
 //! One, the "owner" or foreground thread, interacts with this class in much the
 //! same way as one would interact with a TCPSocket: it connects or listens, writes to
 //! and reads from a reliable data stream, etc. Only the owner thread calls public
-//! methods of this class.
+//! methods of this class. The two threads hand bytes to each other through a pair of
+//! SPSCByteStreams, so a write or read is a memcpy rather than a system call.
 //!
 //! The other, the "TCPPeer" thread, takes care of the back-end tasks that the kernel would
 //! perform for a TCPSocket: reading and parsing datagrams from the wire, filtering out
@@ -118,6 +148,8 @@ using LossyTCPOverIPv4MinnowSocket = TCPMinnowSocket<LossyFdAdapter<TCPOverIPv4O
 //!   and [accept(2)](\ref man2::accept)
 //! - if TCPMinnowSocket is destructed while a TCP connection is open, the connection is
 //!   immediately terminated with a RST (call `wait_until_closed` to avoid this)
+//! - it is not a file descriptor: to wait for it in an EventLoop, poll the eventfds of
+//!   outbound_stream() and inbound_stream()
 
 //! Helper class that makes a TCPOverIPv4MinnowSocket behave more like a (kernel) TCPSocket
 class CS144TCPSocket : public TCPOverIPv4MinnowSocket
@@ -4,12 +4,12 @@
 #include "parser.hh"
 #include "tun.hh"
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <iostream>
 #include <stdexcept>
 #include <string>
-#include <sys/socket.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -30,7 +30,13 @@ void TCPMinnowSocket<AdaptT>::_tcp_loop( const std::function<bool()>& condition
 {
   auto base_time = timestamp_ms();
   while ( condition() ) {
-    auto ret = _eventloop.wait_next_event( TCP_TICK_MS );
+    // When pacing holds back segments, wake up exactly when the next one may go out.
+    uint64_t wait_ms = TCP_TICK_MS;
+    if ( _tcp.has_value() ) {
+      wait_ms = std::min( wait_ms, _tcp->ms_until_next_send().value_or( TCP_TICK_MS ) );
+    }
+
+    auto ret = _eventloop.wait_next_event( static_cast<int>( wait_ms ) );
     if ( ret == EventLoop::Result::Exit or _abort ) {
       break;
     }
@@ -39,26 +45,17 @@ void TCPMinnowSocket<AdaptT>::_tcp_loop( const std::function<bool()>& condition
       throw std::runtime_error( "_tcp_loop entered before TCPPeer initialized" );
     }
 
+    _move_stream_bytes();
+
     if ( _tcp.value().active() ) {
       const auto next_time = timestamp_ms();
-      _tcp.value().tick( next_time - base_time, [&]( auto x ) { _datagram_adapter.write( x ); } );
+      _tcp.value().tick( next_time - base_time, _transmit );
       _datagram_adapter.tick( next_time - base_time );
       base_time = next_time;
     }
-  }
-}
 
-//! \param[in] data_socket_pair is a pair of connected AF_UNIX SOCK_STREAM sockets
-//! \param[in] datagram_interface is the interface for reading and writing datagrams
-template<TCPDatagramAdapter AdaptT>
-TCPMinnowSocket<AdaptT>::TCPMinnowSocket( std::pair<FileDescriptor, FileDescriptor> data_socket_pair,
-                                          AdaptT&& datagram_interface )
-  : LocalStreamSocket( std::move( data_socket_pair.first ) )
-  , _datagram_adapter( std::move( datagram_interface ) )
-  , _thread_data( std::move( data_socket_pair.second ) )
-{
-  _thread_data.set_blocking( false );
-  set_blocking( false );
+    _info.publish( _tcp->info() );
+  }
 }
 
 template<TCPDatagramAdapter AdaptT>
@@ -73,12 +70,15 @@ void TCPMinnowSocket<AdaptT>::_initialize_TCP( const TCPConfig& config )
   // 1) Incoming datagram received (needs to be given to TCPPeer::receive method)
   //
   // 2) Outbound bytes received from local application via a write()
-  //    call (needs to be read from the local stream socket and
+  //    call (needs to be popped from the outbound SPSCByteStream and
   //    given to TCPPeer)
   //
   // 3) Incoming bytes reassembled by the Reassembler
-  //    (needs to be read from the inbound_stream and written
-  //    to the local stream socket back to the application)
+  //    (needs to be read from the inbound_stream and pushed
+  //    to the inbound SPSCByteStream back to the application)
+  //
+  // Events 2 and 3 only touch shared memory, so _tcp_loop moves those bytes after every
+  // wakeup; these rules' eventfds just wake it when the owner makes data or room.
 
   // rule 1: read from filtered packet stream and dump into TCPConnection
   _eventloop.add_rule(
@@ -87,11 +87,11 @@ void TCPMinnowSocket<AdaptT>::_initialize_TCP( const TCPConfig& config )
     Direction::In,
     [&] {
       if ( auto seg = _datagram_adapter.read() ) {
-        _tcp->receive( std::move( seg.value() ), [&]( auto x ) { _datagram_adapter.write( x ); } );
+        _tcp->receive( std::move( seg.value() ), _transmit );
       }
 
       // debugging output:
-      if ( _thread_data.eof() and _tcp.value().sender().sequence_numbers_in_flight() == 0 and not _fully_acked ) {
+      if ( _outbound_shutdown and _tcp.value().sender().sequence_numbers_in_flight() == 0 and not _fully_acked ) {
         std::cerr << "DEBUG: minnow outbound stream to " << _datagram_adapter.config().destination.to_string()
                   << " has been fully acknowledged.\n";
         _fully_acked = true;
@@ -99,96 +99,74 @@ void TCPMinnowSocket<AdaptT>::_initialize_TCP( const TCPConfig& config )
     },
     [&] { return _tcp->active(); } );
 
-  // rule 2: read from pipe into outbound buffer
+  // rule 2: wake up when the owner writes to an empty outbound stream (or closes it)
   _eventloop.add_rule(
-    "push bytes to TCPPeer",
-    _thread_data,
+    "outbound bytes from the owner",
+    _outbound.data_available_fd(),
     Direction::In,
-    [&] {
-      std::string data;
-      data.resize( _tcp->outbound_writer().available_capacity() );
-      _thread_data.read( data );
-      _tcp->outbound_writer().push( move( data ) );
+    [&] { _outbound.clear_data_available(); },
+    [&] { return _tcp->active() and not _outbound_shutdown; } );
 
-      if ( _thread_data.eof() ) {
-        _tcp->outbound_writer().close();
-        _outbound_shutdown = true;
+  // rule 3: wake up when the owner reads from a full inbound stream
+  _eventloop.add_rule(
+    "room in the inbound stream",
+    _inbound.space_available_fd(),
+    Direction::In,
+    [&] { _inbound.clear_space_available(); },
+    [&] { return not _inbound_shutdown and _tcp->inbound_reader().bytes_buffered(); } );
+}
 
-        // debugging output:
-        std::cerr << "DEBUG: minnow outbound stream to " << _datagram_adapter.config().destination.to_string()
-                  << " finished (" << _tcp.value().sender().sequence_numbers_in_flight() << " seqno"
-                  << ( _tcp.value().sender().sequence_numbers_in_flight() == 1 ? "" : "s" )
-                  << " still in flight).\n";
-      }
+template<TCPDatagramAdapter AdaptT>
+void TCPMinnowSocket<AdaptT>::_move_stream_bytes()
+{
+  // outbound stream -> TCPPeer
+  Writer& outbound = _tcp->outbound_writer();
+  if ( not _outbound_shutdown and _outbound.bytes_buffered() and outbound.available_capacity() ) {
+    while ( _outbound.bytes_buffered() and outbound.available_capacity() ) {
+      const std::string_view data = _outbound.peek();
+      const uint64_t len = std::min<uint64_t>( data.size(), outbound.available_capacity() );
+      outbound.push( data.substr( 0, len ) );
+      _outbound.pop( len );
+    }
+    _tcp->push( _transmit );
+  }
 
-      _tcp->push( [&]( auto x ) { _datagram_adapter.write( x ); } );
-    },
-    [&] {
-      return ( _tcp->active() ) and ( not _outbound_shutdown )
-             and ( _tcp->outbound_writer().available_capacity() > 0 );
-    },
-    [&] {
-      _tcp->outbound_writer().close();
-      _outbound_shutdown = true;
-    },
-    [&] {
-      std::cerr << "DEBUG: minnow outbound stream had error.\n";
-      _tcp->outbound_writer().set_error();
-    } );
+  if ( not _outbound_shutdown and _outbound.is_finished() ) {
+    outbound.close();
+    _outbound_shutdown = true;
+    _tcp->push( _transmit );
 
-  // rule 3: read from inbound buffer into pipe
-  _eventloop.add_rule(
-    "read bytes from inbound stream",
-    _thread_data,
-    Direction::Out,
-    [&] {
-      Reader& inbound = _tcp->inbound_reader();
-      // Write from the inbound_stream into
-      // the pipe, handling the possibility of a partial
-      // write (i.e., only pop what was actually written).
-      if ( inbound.bytes_buffered() ) {
-        const std::string_view buffer = inbound.peek();
-        const auto bytes_written = _thread_data.write( buffer );
-        inbound.pop( bytes_written );
-      }
+    // debugging output:
+    std::cerr << "DEBUG: minnow outbound stream to " << _datagram_adapter.config().destination.to_string()
+              << " finished (" << _tcp.value().sender().sequence_numbers_in_flight() << " seqno"
+              << ( _tcp.value().sender().sequence_numbers_in_flight() == 1 ? "" : "s" ) << " still in flight).\n";
+  }
 
-      if ( inbound.is_finished() or inbound.has_error() ) {
-        _thread_data.shutdown( SHUT_WR );
-        _inbound_shutdown = true;
+  // TCPPeer -> inbound stream, handling the possibility of a partial push
+  // (i.e., only pop what was actually pushed). Once the owner has stopped
+  // reading, the bytes are dropped instead.
+  Reader& inbound = _tcp->inbound_reader();
+  if ( _inbound_shutdown ) {
+    return;
+  }
+  while ( inbound.bytes_buffered() and ( _owner_done or _inbound.available_capacity() ) ) {
+    inbound.pop( _owner_done ? inbound.bytes_buffered() : _inbound.push( inbound.peek() ) );
+  }
 
-        // debugging output:
-        std::cerr << "DEBUG: minnow inbound stream from " << _datagram_adapter.config().destination.to_string()
-                  << " finished " << ( inbound.has_error() ? "uncleanly.\n" : "cleanly.\n" );
-      }
-    },
-    [&] {
-      return _tcp->inbound_reader().bytes_buffered()
-             or ( ( _tcp->inbound_reader().is_finished() or _tcp->inbound_reader().has_error() )
-                  and not _inbound_shutdown );
-    },
-    [&] {},
-    [&] {
-      std::cerr << "DEBUG: minnow inbound stream had error.\n";
-      _tcp->inbound_reader().set_error();
-    } );
-}
+  if ( inbound.is_finished() or inbound.has_error() ) {
+    _inbound.close();
+    _inbound_shutdown = true;
 
-//! \brief Call [socketpair](\ref man2::socketpair) and return connected Unix-domain sockets of specified type
-//! \param[in] type is the type of AF_UNIX sockets to create (e.g., SOCK_SEQPACKET)
-//! \returns a std::pair of connected sockets
-template<std::derived_from<Socket> SocketType>
-inline std::pair<SocketType, SocketType> socket_pair_helper( int domain, int type, int protocol = 0 )
-{
-  std::array<int, 2> fds {};
-  CheckSystemCall( "socketpair", ::socketpair( domain, type, protocol, fds.data() ) );
-  return { SocketType { FileDescriptor { fds[0] } }, SocketType { FileDescriptor { fds[1] } } };
+    // debugging output:
+    std::cerr << "DEBUG: minnow inbound stream from " << _datagram_adapter.config().destination.to_string()
+              << " finished " << ( inbound.has_error() ? "uncleanly.\n" : "cleanly.\n" );
+  }
 }
 
 //! \param[in] datagram_interface is the underlying interface (e.g. to UDP, IP, or Ethernet)
 template<TCPDatagramAdapter AdaptT>
 TCPMinnowSocket<AdaptT>::TCPMinnowSocket( AdaptT&& datagram_interface )
-  : TCPMinnowSocket( socket_pair_helper<LocalStreamSocket>( AF_UNIX, SOCK_STREAM ),
-                     std::move( datagram_interface ) )
+  : _datagram_adapter( std::move( datagram_interface ) )
 {}
 
 template<TCPDatagramAdapter AdaptT>
@@ -209,7 +187,8 @@ TCPMinnowSocket<AdaptT>::~TCPMinnowSocket()
 template<TCPDatagramAdapter AdaptT>
 void TCPMinnowSocket<AdaptT>::wait_until_closed()
 {
-  shutdown( SHUT_RDWR );
+  close();
+  _owner_done.store( true );
   if ( _tcp_thread.joinable() ) {
     std::cerr << "DEBUG: minnow waiting for clean shutdown... ";
     _tcp_thread.join();
@@ -236,7 +215,7 @@ void TCPMinnowSocket<AdaptT>::connect( const TCPConfig& c_tcp, const FdAdapterCo
     throw std::runtime_error( "TCPPeer not successfully initialized" );
   }
 
-  _tcp->push( [&]( auto x ) { _datagram_adapter.write( x ); } );
+  _tcp->push( _transmit );
 
   if ( _tcp->sender().sequence_numbers_in_flight() != 1 ) {
     throw std::runtime_error( "After TCPConnection::connect(), expected sequence_numbers_in_flight() == 1" );
@@ -281,7 +260,7 @@ void TCPMinnowSocket<AdaptT>::_tcp_main()
       throw std::runtime_error( "no TCP" );
     }
     _tcp_loop( [] { return true; } );
-    shutdown( SHUT_RDWR );
+    _inbound.close();
     if ( not _tcp.value().active() ) {
       std::cerr << "DEBUG: minnow TCP connection finished "
                 << ( _tcp->inbound_reader().has_error() ? "uncleanly.\n" : "cleanly.\n" );
@@ -292,3 +271,33 @@ void TCPMinnowSocket<AdaptT>::_tcp_main()
     throw e;
   }
 }
+
+template<TCPDatagramAdapter AdaptT>
+size_t TCPMinnowSocket<AdaptT>::write( std::string_view data )
+{
+  return _outbound.push( data );
+}
+
+template<TCPDatagramAdapter AdaptT>
+void TCPMinnowSocket<AdaptT>::read( std::string& buffer )
+{
+  buffer.clear();
+  const uint64_t len = _inbound.bytes_buffered();
+  while ( buffer.size() < len ) { // at most two pieces, on either side of the ring's wraparound
+    const std::string_view data = _inbound.peek().substr( 0, len - buffer.size() );
+    buffer.append( data );
+    _inbound.pop( data.size() );
+  }
+}
+
+template<TCPDatagramAdapter AdaptT>
+bool TCPMinnowSocket<AdaptT>::eof() const
+{
+  return _inbound.is_finished();
+}
+
+template<TCPDatagramAdapter AdaptT>
+void TCPMinnowSocket<AdaptT>::close()
+{
+  _outbound.close();
+}
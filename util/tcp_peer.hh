@@ -1,14 +1,18 @@
 #pragma once
 
 #include "tcp_config.hh"
+#include "tcp_info.hh"
 #include "tcp_receiver.hh"
 #include "tcp_receiver_message.hh"
 #include "tcp_segment.hh"
 #include "tcp_sender.hh"
 #include "tcp_sender_message.hh"
 
+#include <algorithm>
 #include <functional>
 #include <optional>
+#include <span>
+#include <vector>
 
 class TCPPeer
 {
@@ -26,14 +30,52 @@ public:
   /* Type of the `transmit` function that the push and tick methods can use to send messages */
   using TransmitFunction = std::function<void( TCPMessage )>;
 
+  /* Batched alternative: everything one call produces (e.g. a full window) is handed over at once */
+  using BatchTransmitFunction = std::function<void( std::span<const TCPMessage> )>;
+
   /* Passthrough methods */
-  void push( const TransmitFunction& transmit ) { sender_.push( make_send( transmit ) ); }
+  void push( const TransmitFunction& transmit )
+  {
+    sender_.push( make_send( transmit ) );
+    send_window_update( transmit );
+  }
   void tick( uint64_t t, const TransmitFunction& transmit )
   {
     cumulative_time_ += t;
+    if ( has_ackno() and receive_window_closed() ) {
+      info_.recv_window_zero_ms += t;
+    }
     sender_.tick( t, make_send( transmit ) );
+
+    // A delayed ACK that nothing else has carried goes out when its timer expires.
+    if ( ack_pending_ and cumulative_time_ >= ack_deadline_ ) {
+      send( sender_.make_empty_message(), transmit );
+    }
+    send_window_update( transmit );
+  }
+  bool has_ackno() const { return receiver_.ackno().has_value(); }
+
+  /* Segment coalescing (see TCPSender::cork) */
+  void cork() { sender_.cork(); }
+  void uncork( const TransmitFunction& transmit )
+  {
+    sender_.uncork();
+    push( transmit );
+  }
+  void flush( const TransmitFunction& transmit )
+  {
+    sender_.flush();
+    push( transmit );
+  }
+  std::optional<uint64_t> ms_until_next_send() const
+  {
+    auto ms = sender_.ms_until_next_send();
+    if ( ack_pending_ ) {
+      const uint64_t ack_ms = ack_deadline_ > cumulative_time_ ? ack_deadline_ - cumulative_time_ : 0;
+      ms = std::min( ms.value_or( ack_ms ), ack_ms );
+    }
+    return ms;
   }
-  bool has_ackno() const { return receiver_.send().ackno.has_value(); }
 
   /* Is the peer still active? */
   bool active() const
@@ -56,24 +98,57 @@ public:
     // Record time in case this peer has to linger after streams finish.
     time_of_last_receipt_ = cumulative_time_;
 
-    // If SenderMessage occupies a sequence number, make sure to reply.
-    need_send_ |= ( msg.sender.sequence_length() > 0 );
+    ++info_.segments_received;
+    info_.bytes_received += msg.sender.payload.size();
 
     // If SenderMessage is a "keep-alive" (with intentionally invalid seqno), make sure to reply.
     // (N.B. orthodox TCP rules require a reply on any unacceptable segment.)
-    const auto our_ackno = receiver_.send().ackno;
+    const auto our_ackno = receiver_.ackno();
     need_send_ |= ( our_ackno.has_value() and msg.sender.seqno + 1 == our_ackno.value() );
 
+    // Remember enough about the segment to decide below whether its ACK may be delayed.
+    const uint64_t seg_length = msg.sender.sequence_length();
+    const uint64_t seg_payload = msg.sender.payload.size();
+    const bool seg_plain = not msg.sender.SYN and not msg.sender.FIN;
+    const bool seg_in_order = our_ackno.has_value() and msg.sender.seqno == our_ackno.value();
+    info_.out_of_order_segments += ( seg_payload > 0 and our_ackno.has_value() and not seg_in_order );
+
     // Did the inbound stream finish before the outbound stream? If so, no need to linger after streams finish.
     if ( receiver_.writer().is_closed() and not sender_.reader().is_finished() ) {
       linger_after_streams_finish_ = false;
     }
 
+    // The peer's SYN says how large a segment it will accept, whether its windows are scaled,
+    // and whether it uses timestamps.
+    const bool peer_syn = msg.sender.SYN;
+    const auto peer_window_scale = msg.sender.window_scale;
+    if ( peer_syn and msg.sender.mss.has_value() ) {
+      sender_.set_peer_mss( msg.sender.mss.value() );
+    }
+    if ( peer_syn ) {
+      sender_.set_peer_timestamps( msg.sender.timestamp.has_value() );
+    }
+
     // Give incoming TCPSenderMessage to receiver.
     receiver_.receive( std::move( msg.sender ) );
 
-    // Give incoming TCPReceiverMessage to sender.
-    sender_.receive( msg.receiver );
+    // If SenderMessage occupies a sequence number, make sure to reply (now, or within delayed_ack_ms).
+    if ( seg_length > 0 ) {
+      const auto new_ackno = receiver_.ackno();
+      const bool advanced_by_segment
+        = seg_in_order and new_ackno.has_value()
+          and new_ackno.value() == our_ackno.value() + static_cast<uint32_t>( seg_length );
+      schedule_ack( seg_plain and advanced_by_segment, seg_payload );
+    }
+
+    // Give incoming TCPReceiverMessage to sender. (The window on a SYN is never scaled.)
+    sender_.receive( msg.receiver, seg_length == 0 );
+    if ( peer_syn and peer_window_scale.has_value() ) {
+      sender_.set_peer_window_scale( peer_window_scale.value() );
+    }
+
+    // Send whatever the ACK made room for (including any fast retransmission).
+    push( transmit );
 
     // Send reply if needed.
     if ( need_send_ ) {
@@ -81,22 +156,143 @@ public:
     }
   }
 
+  /* Batched versions of the methods above: `transmit` is called at most once, with every message sent */
+  void push( const BatchTransmitFunction& transmit )
+  {
+    batch( transmit, [&]( const TransmitFunction& t ) { push( t ); } );
+  }
+  void tick( uint64_t t, const BatchTransmitFunction& transmit )
+  {
+    batch( transmit, [&]( const TransmitFunction& each ) { tick( t, each ); } );
+  }
+  void receive( TCPMessage msg, const BatchTransmitFunction& transmit )
+  {
+    batch( transmit, [&]( const TransmitFunction& t ) { receive( std::move( msg ), t ); } );
+  }
+  void uncork( const BatchTransmitFunction& transmit )
+  {
+    batch( transmit, [&]( const TransmitFunction& t ) { uncork( t ); } );
+  }
+  void flush( const BatchTransmitFunction& transmit )
+  {
+    batch( transmit, [&]( const TransmitFunction& t ) { flush( t ); } );
+  }
+
+  /* Connection statistics */
+  TCPInfo info() const
+  {
+    TCPInfo info = info_;
+    info.segments_retransmitted = sender_.segments_retransmitted();
+    info.bytes_retransmitted = sender_.bytes_retransmitted();
+    info.timeouts = sender_.timeouts();
+    info.fast_retransmits = sender_.fast_retransmits();
+    info.loss_retransmits = sender_.loss_retransmits();
+    info.tail_loss_probes = sender_.tail_loss_probes();
+    info.window_probes = sender_.window_probes();
+    info.bytes_in_flight = sender_.sequence_numbers_in_flight();
+    info.bytes_in_pipe = sender_.bytes_in_pipe();
+    info.cwnd = sender_.congestion_window();
+    info.ssthresh = sender_.slow_start_threshold();
+    info.mss = sender_.mss();
+    info.rto_ms = sender_.current_RTO_ms();
+    if ( sender_.rtt_estimator().has_sample() ) {
+      info.srtt_ms = sender_.rtt_estimator().srtt_ms();
+      info.rttvar_ms = sender_.rtt_estimator().rttvar_ms();
+    }
+    info.paws_rejected = receiver_.paws_rejected();
+    info.reassembler_pending = receiver_.reassembler().bytes_pending();
+    return info;
+  }
+
   // Testing interface
   const TCPReceiver& receiver() const { return receiver_; }
   const TCPSender& sender() const { return sender_; }
 
 private:
   TCPConfig cfg_;
-  TCPSender sender_ { ByteStream { cfg_.send_capacity }, cfg_.isn, cfg_.rt_timeout };
-  TCPReceiver receiver_ { Reassembler { ByteStream { cfg_.recv_capacity } } };
+  TCPSender sender_ { ByteStream { cfg_.send_capacity }, cfg_ };
+  TCPReceiver receiver_ { Reassembler { ByteStream { cfg_.recv_capacity }, cfg_.max_held_ranges },
+                          cfg_.sack_recovery or cfg_.rack_tlp };
 
   bool need_send_ {};
 
+  TCPInfo info_ {}; // the counters only the peer sees; info() fills in the rest
+
+  bool receive_window_closed() const
+  {
+    const uint8_t shift = receiver_.window_scaling() ? receiver_.window_scale() : 0;
+    return ( receiver_.writer().available_capacity() >> shift ) == 0;
+  }
+
+  // Messages collected during one batched call (kept across calls so steady state doesn't allocate)
+  std::vector<TCPMessage> outbox_ {};
+
+  void batch( const BatchTransmitFunction& transmit, const std::function<void( const TransmitFunction& )>& op )
+  {
+    outbox_.clear();
+    op( [&]( TCPMessage msg ) { outbox_.push_back( std::move( msg ) ); } );
+    if ( not outbox_.empty() ) {
+      transmit( outbox_ );
+    }
+  }
+
+  // Delayed ACKs (RFC 1122, RFC 5681): in-order data is acknowledged every delayed_ack_segments full
+  // segments or after delayed_ack_ms, whichever comes first, unless a data segment carries the ACK sooner.
+  // "Full" is measured against the peer's segment size, estimated as the largest payload seen so far
+  // (its MSS may be smaller than ours). SYN, FIN, out-of-order, duplicate and hole-filling segments are
+  // acknowledged right away.
+  bool ack_pending_ {};
+  uint64_t ack_deadline_ {};
+  uint64_t unacked_segments_ {};
+  uint64_t peer_segment_size_ {};
+
+  void schedule_ack( bool may_delay, uint64_t payload_bytes )
+  {
+    peer_segment_size_ = std::max( peer_segment_size_, payload_bytes );
+    if ( not may_delay or cfg_.delayed_ack_ms == 0 ) {
+      need_send_ = true;
+      return;
+    }
+
+    if ( not ack_pending_ ) {
+      ack_pending_ = true;
+      ack_deadline_ = cumulative_time_ + cfg_.delayed_ack_ms;
+    }
+    unacked_segments_ += ( payload_bytes >= peer_segment_size_ );
+    need_send_ |= ( unacked_segments_ >= cfg_.delayed_ack_segments );
+  }
+
+  // Window updates (RFC 9293 3.8.6.2.2): once the application has read enough that a window we
+  // advertised as zero has reopened by min(MSS, half the buffer), say so right away rather than
+  // leaving the peer to find out with its next window probe.
+  bool advertised_zero_window_ {};
+
+  void send_window_update( const TransmitFunction& transmit )
+  {
+    if ( not advertised_zero_window_ or receiver_.window_size() == 0 ) {
+      return;
+    }
+    const uint64_t threshold = std::max<uint64_t>( 1, std::min<uint64_t>( cfg_.mss, cfg_.recv_capacity / 2 ) );
+    if ( receiver_.writer().available_capacity() >= threshold ) {
+      send( sender_.make_empty_message(), transmit );
+    }
+  }
+
   void send( const TCPSenderMessage& sender_message, const TransmitFunction& transmit )
   {
     TCPMessage msg { sender_message, receiver_.send() };
+    if ( msg.sender.SYN ) {
+      msg.sender.window_scale = receiver_.window_scale();
+      msg.sender.sack_permitted = receiver_.offers_sack();
+      msg.receiver.window_size = receiver_.syn_window_size();
+    }
+    ++info_.segments_sent;
+    info_.bytes_sent += msg.sender.payload.size();
+    advertised_zero_window_ = msg.receiver.ackno.has_value() and msg.receiver.window_size == 0;
     transmit( std::move( msg ) );
     need_send_ = false;
+    ack_pending_ = false; // every segment carries the current ackno
+    unacked_segments_ = 0;
   }
 
   bool linger_after_streams_finish_ { true }; // one peer may need to linger to make sure all closure conditions met
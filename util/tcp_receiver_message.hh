@@ -2,12 +2,15 @@
 
 #include "wrapping_integers.hh"
 
+#include <array>
+#include <cstddef>
+#include <initializer_list>
 #include <optional>
 
 /*
  * The TCPReceiverMessage structure contains the information sent from a TCP receiver to its sender.
  *
- * It contains three fields:
+ * It contains five fields:
  *
  * 1) The acknowledgment number (ackno): the *next* sequence number needed by the TCP Receiver.
  *    This is an optional field that is empty if the TCPReceiver hasn't yet received the Initial Sequence Number.
@@ -17,11 +20,63 @@
  *    the <cstdint> header).
  *
  * 3) The RST (reset) flag. If set, the stream has suffered an error and the connection should be aborted.
+ *
+ * 4) The selective-acknowledgment (SACK) blocks: ranges of sequence numbers beyond the ackno that the
+ *    receiver already holds, most recently received first. At most MAX_SACK_BLOCKS fit in the option
+ *    space, or MAX_SACK_BLOCKS_WITH_TIMESTAMP when the segment also carries the timestamp option.
+ *
+ * 5) The timestamp echo (TSecr, RFC 7323): the timestamp of the segment that most recently advanced
+ *    the ackno, which lets the sender measure the RTT even for retransmitted segments.
  */
 
+// A contiguous block of received sequence numbers: [left, right)
+struct SACKBlock
+{
+  Wrap32 left { 0 };
+  Wrap32 right { 0 };
+};
+
+// The SACK blocks of one message, kept inline so that building a message never allocates.
+// Blocks beyond the capacity (more than the option space can carry) are ignored.
+class SACKBlockList
+{
+public:
+  static constexpr size_t CAPACITY = 4;
+
+  SACKBlockList() = default;
+  SACKBlockList( std::initializer_list<SACKBlock> blocks )
+  {
+    for ( const SACKBlock& block : blocks ) {
+      push_back( block );
+    }
+  }
+
+  void push_back( const SACKBlock& block )
+  {
+    if ( size_ < CAPACITY ) {
+      blocks_[size_++] = block;
+    }
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const SACKBlock& operator[]( size_t i ) const { return blocks_[i]; }
+  const SACKBlock* begin() const { return blocks_.data(); }
+  const SACKBlock* end() const { return blocks_.data() + size_; }
+
+private:
+  std::array<SACKBlock, CAPACITY> blocks_ {};
+  size_t size_ {};
+};
+
 struct TCPReceiverMessage
 {
   std::optional<Wrap32> ackno {};
   uint16_t window_size {};
   bool RST {};
+  SACKBlockList sack_blocks {};
+  std::optional<uint32_t> timestamp_echo {};
+
+  static constexpr size_t MAX_SACK_BLOCKS = SACKBlockList::CAPACITY; // 40 option bytes: 4 + 8 per block
+  static constexpr size_t MAX_SACK_BLOCKS_WITH_TIMESTAMP = 3; // the timestamp option takes 12 of them
 };
@@ -4,10 +4,156 @@
 
 #include <cstddef>
 
-static constexpr uint32_t TCPHeaderMinLen = 5; // 32-bit words
+static constexpr uint32_t TCPHeaderMinLen = 5;       // 32-bit words
+static constexpr uint32_t TCPOptionsMaxLen = 40;     // bytes
+static constexpr uint8_t TCPOptionEnd = 0;           // end of option list
+static constexpr uint8_t TCPOptionNop = 1;           // padding
+static constexpr uint8_t TCPOptionMSS = 2;           // RFC 9293, sent on SYN
+static constexpr uint8_t TCPOptionWindowScale = 3;   // RFC 7323, sent on SYN
+static constexpr uint8_t TCPMaxWindowScale = 14;     // RFC 7323
+static constexpr uint8_t TCPOptionSACKPermitted = 4; // RFC 2018, sent on SYN
+static constexpr uint8_t TCPOptionSACK = 5;          // RFC 2018
+static constexpr uint8_t TCPOptionTimestamps = 8;    // RFC 7323
 
 using namespace std;
 
+class Wrap32Serializable : public Wrap32
+{
+public:
+  uint32_t raw_value() const { return raw_value_; }
+};
+
+namespace {
+
+// Parse `options_len` bytes of TCP options, filling in the fields of `message` that minnow understands
+void parse_options( Parser& parser, size_t options_len, TCPMessage& message )
+{
+  while ( options_len > 0 and not parser.has_error() ) {
+    uint8_t kind {};
+    parser.integer( kind );
+    --options_len;
+
+    if ( kind == TCPOptionEnd ) {
+      break;
+    }
+    if ( kind == TCPOptionNop ) {
+      continue;
+    }
+
+    uint8_t len {};
+    parser.integer( len );
+    if ( len < 2 or len - 1U > options_len ) {
+      parser.set_error();
+      return;
+    }
+    options_len -= len - 1;
+    size_t body_len = len - 2;
+
+    if ( kind == TCPOptionMSS and body_len == 2 ) {
+      uint16_t mss {};
+      parser.integer( mss );
+      message.sender.mss = mss;
+      body_len = 0;
+    }
+
+    if ( kind == TCPOptionWindowScale and body_len == 1 ) {
+      uint8_t shift {};
+      parser.integer( shift );
+      message.sender.window_scale = min( shift, TCPMaxWindowScale );
+      body_len = 0;
+    }
+
+    if ( kind == TCPOptionSACKPermitted and body_len == 0 ) {
+      message.sender.sack_permitted = true;
+    }
+
+    if ( kind == TCPOptionTimestamps and body_len == 8 ) {
+      uint32_t tsval {};
+      uint32_t tsecr {};
+      parser.integer( tsval );
+      parser.integer( tsecr );
+      message.sender.timestamp = tsval;
+      message.receiver.timestamp_echo = tsecr;
+      body_len = 0;
+    }
+
+    if ( kind == TCPOptionSACK and body_len % 8 == 0 ) {
+      for ( ; body_len > 0; body_len -= 8 ) {
+        uint32_t left {};
+        uint32_t right {};
+        parser.integer( left );
+        parser.integer( right );
+        message.receiver.sack_blocks.push_back( { Wrap32 { left }, Wrap32 { right } } );
+      }
+    }
+
+    parser.remove_prefix( body_len ); // skip unknown options
+  }
+
+  parser.remove_prefix( options_len ); // anything after the end-of-option-list marker
+}
+
+// Serialize the options that `message` calls for, padded to a multiple of four bytes
+string serialize_options( const TCPMessage& message )
+{
+  Serializer options;
+  size_t len = 0;
+
+  if ( message.sender.SYN and message.sender.mss.has_value() ) {
+    options.integer( TCPOptionMSS );
+    options.integer( uint8_t { 4 } );
+    options.integer( message.sender.mss.value() );
+    len += 4;
+  }
+
+  if ( message.sender.SYN and message.sender.window_scale.has_value() ) {
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionWindowScale );
+    options.integer( uint8_t { 3 } );
+    options.integer( message.sender.window_scale.value() );
+    len += 4;
+  }
+
+  if ( message.sender.SYN and message.sender.sack_permitted ) {
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionSACKPermitted );
+    options.integer( uint8_t { 2 } );
+    len += 4;
+  }
+
+  if ( message.sender.timestamp.has_value() ) {
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionTimestamps );
+    options.integer( uint8_t { 10 } );
+    options.integer( message.sender.timestamp.value() );
+    options.integer( message.receiver.timestamp_echo.value_or( 0 ) );
+    len += 12;
+  }
+
+  const size_t sack_blocks = min( message.receiver.sack_blocks.size(), ( TCPOptionsMaxLen - len - 4 ) / 8 );
+  if ( sack_blocks > 0 ) {
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionNop );
+    options.integer( TCPOptionSACK );
+    options.integer( static_cast<uint8_t>( 2 + 8 * sack_blocks ) );
+    for ( size_t i = 0; i < sack_blocks; ++i ) {
+      options.integer( Wrap32Serializable { message.receiver.sack_blocks[i].left }.raw_value() );
+      options.integer( Wrap32Serializable { message.receiver.sack_blocks[i].right }.raw_value() );
+    }
+    len += 4 + 8 * sack_blocks;
+  }
+
+  string ret;
+  for ( const auto& buf : options.output() ) {
+    ret += buf;
+  }
+  return ret;
+}
+
+} // namespace
+
 void TCPSegment::parse( Parser& parser, uint32_t datagram_layer_pseudo_checksum )
 {
   /* verify checksum */
@@ -47,28 +193,26 @@ void TCPSegment::parse( Parser& parser, uint32_t datagram_layer_pseudo_checksum
   parser.integer( udinfo.cksum );
   parser.integer( raw16 ); // urgent pointer
 
-  // skip any options or anything extra in the header
   if ( data_offset < TCPHeaderMinLen ) {
     parser.set_error();
+    return;
+  }
+  parse_options( parser, data_offset * 4 - TCPHeaderMinLen * 4, message );
+  if ( not message.receiver.ackno.has_value() ) {
+    message.receiver.timestamp_echo.reset(); // TSecr is only meaningful with ACK set
   }
-  parser.remove_prefix( data_offset * 4 - TCPHeaderMinLen * 4 );
 
   parser.all_remaining( message.sender.payload );
 }
 
-class Wrap32Serializable : public Wrap32
-{
-public:
-  uint32_t raw_value() const { return raw_value_; }
-};
-
 void TCPSegment::serialize( Serializer& serializer ) const
 {
   serializer.integer( udinfo.src_port );
   serializer.integer( udinfo.dst_port );
   serializer.integer( Wrap32Serializable { message.sender.seqno }.raw_value() );
   serializer.integer( Wrap32Serializable { message.receiver.ackno.value_or( Wrap32 { 0 } ) }.raw_value() );
-  serializer.integer( uint8_t { TCPHeaderMinLen << 4 } ); // data offset
+  const string options = serialize_options( message );
+  serializer.integer( static_cast<uint8_t>( ( TCPHeaderMinLen + options.size() / 4 ) << 4 ) ); // data offset
   const bool reset = message.sender.RST or message.receiver.RST;
   const uint8_t flags = ( message.receiver.ackno.has_value() ? 0b0001'0000U : 0 ) | ( reset ? 0b0000'0100U : 0 )
                         | ( message.sender.SYN ? 0b0000'0010U : 0 ) | ( message.sender.FIN ? 0b0000'0001U : 0 );
@@ -76,6 +220,9 @@ void TCPSegment::serialize( Serializer& serializer ) const
   serializer.integer( message.receiver.window_size );
   serializer.integer( udinfo.cksum );
   serializer.integer( uint16_t { 0 } ); // urgent pointer
+  for ( const char c : options ) {
+    serializer.integer( static_cast<uint8_t>( c ) );
+  }
   serializer.buffer( message.sender.payload );
 }
 
@@ -2,12 +2,14 @@
 
 #include "wrapping_integers.hh"
 
+#include <cstdint>
+#include <optional>
 #include <string>
 
 /*
  * The TCPSenderMessage structure contains the information sent from a TCP sender to its receiver.
  *
- * It contains five fields:
+ * It contains nine fields:
  *
  * 1) The sequence number (seqno) of the beginning of the segment. If the SYN flag is set, this is the
  *    sequence number of the SYN flag. Otherwise, it's the sequence number of the beginning of the payload.
@@ -20,6 +22,17 @@
  * 4) The FIN flag. If set, the payload represents the ending of the byte stream.
  *
  * 5) The RST (reset) flag. If set, the stream has suffered an error and the connection should be aborted.
+ *
+ * 6) The maximum segment size (MSS) the sender is willing to receive, carried only on a SYN.
+ *
+ * 7) The window scale (RFC 7323): the shift the sender's side applies to the windows it advertises,
+ *    carried only on a SYN. Scaling is in effect only if both SYNs carried it.
+ *
+ * 8) The timestamp (TSval, RFC 7323): the sender's clock, in milliseconds, when the segment was sent.
+ *    The peer echoes it back so every ACK yields an RTT sample, and uses it to reject old duplicates (PAWS).
+ *
+ * 9) SACK-permitted (RFC 2018): the sender is willing to receive SACK blocks, carried only on a SYN.
+ *    Either side sends SACK blocks only if both SYNs carried it.
  */
 
 struct TCPSenderMessage
@@ -32,6 +45,11 @@ struct TCPSenderMessage
 
   bool RST {};
 
+  std::optional<uint16_t> mss {};
+  std::optional<uint8_t> window_scale {};
+  std::optional<uint32_t> timestamp {};
+  bool sack_permitted {};
+
   // How many sequence numbers does this segment use?
   size_t sequence_length() const { return SYN + payload.size() + FIN; }
 };
@@ -17,5 +17,37 @@ optional<TCPMessage> TCPOverIPv4OverTunFdAdapter::read()
   return {};
 }
 
+void TCPOverIPv4OverTunFdAdapter::write( span<const TCPMessage> segs )
+{
+  for ( const auto& seg : segs ) {
+    write( seg );
+  }
+}
+
+optional<TCPMessage> TCPOverIPv4OverUDPFdAdapter::read()
+{
+  Address source { "0", 0 };
+  string payload;
+  _socket.recv( source, payload );
+
+  InternetDatagram ip_dgram;
+  if ( parse( ip_dgram, { std::move( payload ) } ) ) {
+    return unwrap_tcp_in_ip( ip_dgram );
+  }
+  return {};
+}
+
+void TCPOverIPv4OverUDPFdAdapter::write( span<const TCPMessage> segs )
+{
+  _outbox.resize( segs.size() );
+  for ( size_t i = 0; i < segs.size(); ++i ) {
+    _outbox[i] = serialize( wrap_tcp_in_ip( segs[i] ) );
+  }
+  _socket.send_batch( _outbox );
+}
+
 //! Specialize LossyFdAdapter to TCPOverIPv4OverTunFdAdapter
 template class LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>;
+
+//! Specialize LossyFdAdapter to TCPOverIPv4OverUDPFdAdapter
+template class LossyFdAdapter<TCPOverIPv4OverUDPFdAdapter>;
@@ -1,19 +1,28 @@
 #pragma once
 
 #include "tcp_over_ip.hh"
+#include "socket.hh"
 #include "tcp_segment.hh"
 #include "tun.hh"
 
 #include <optional>
+#include <span>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 template<class T>
-concept TCPDatagramAdapter = requires( T a, TCPMessage seg ) {
+concept TCPDatagramAdapter = requires( T a, TCPMessage seg, std::span<const TCPMessage> batch )
+{
   {
     a.write( seg )
   } -> std::same_as<void>;
 
+  {
+    a.write( batch )
+    } -> std::same_as<void>;
+
   {
     a.read()
   } -> std::same_as<std::optional<TCPMessage>>;
@@ -35,6 +44,9 @@ public:
   //! Creates an IPv4 datagram from a TCP segment and writes it to the TUN device
   void write( const TCPMessage& seg ) { _tun.write( serialize( wrap_tcp_in_ip( seg ) ) ); }
 
+  //! Writes a burst of TCP segments, one datagram each (a TUN device takes one packet per write)
+  void write( std::span<const TCPMessage> segs );
+
   //! Access the underlying TUN device
   explicit operator TunFD&() { return _tun; }
 
@@ -45,5 +57,32 @@ public:
   FileDescriptor& fd() { return _tun; }
 };
 
+//! \brief A FD adapter for IPv4 datagrams carried in the payloads of a connected UDP socket
+//! \details Unlike a TUN device, a socket takes a whole burst of datagrams in one system call.
+class TCPOverIPv4OverUDPFdAdapter : public TCPOverIPv4Adapter
+{
+private:
+  UDPSocket _socket;
+  std::vector<std::vector<std::string>> _outbox {}; //!< Serialized datagrams of the burst being written
+
+public:
+  //! Construct from a UDPSocket that is already connected to the far end of the tunnel
+  explicit TCPOverIPv4OverUDPFdAdapter( UDPSocket&& socket ) : _socket( std::move( socket ) ) {}
+
+  //! Attempts to read and parse an IPv4 datagram containing a TCP segment related to the current connection
+  std::optional<TCPMessage> read();
+
+  //! Creates an IPv4 datagram from a TCP segment and sends it on the socket
+  void write( const TCPMessage& seg ) { _socket.write( serialize( wrap_tcp_in_ip( seg ) ) ); }
+
+  //! Writes a burst of TCP segments with one [sendmmsg(2)](\ref man2::sendmmsg) call
+  void write( std::span<const TCPMessage> segs );
+
+  //! Access underlying file descriptor
+  FileDescriptor& fd() { return _socket; }
+};
+
 static_assert( TCPDatagramAdapter<TCPOverIPv4OverTunFdAdapter> );
 static_assert( TCPDatagramAdapter<LossyFdAdapter<TCPOverIPv4OverTunFdAdapter>> );
+static_assert( TCPDatagramAdapter<TCPOverIPv4OverUDPFdAdapter> );
+static_assert( TCPDatagramAdapter<LossyFdAdapter<TCPOverIPv4OverUDPFdAdapter>> );